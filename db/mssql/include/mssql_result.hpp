@@ -28,6 +28,7 @@
 #include <windows.h>
 #endif
 
+#include <cstdlib>
 #include <vector>
 
 #include <sqltypes.h>
@@ -46,7 +47,17 @@ private:
   mssql_result& operator=(const mssql_result&) = delete;
 
 public:
-  explicit mssql_result(SQLHANDLE stmt);
+  /**
+   * Creates a result of the given statement handle.
+   * If block fetch is enabled and all columns can be
+   * bound, the rows are fetched as arrays of
+   * ROW_ARRAY_SIZE rows into column wise bound
+   * buffers instead of row by row.
+   *
+   * @param stmt The statement handle
+   * @param block_fetch True if rows may be fetched as arrays
+   */
+  explicit mssql_result(SQLHANDLE stmt, bool block_fetch = false);
   virtual ~mssql_result();
 
   virtual const char* column(size_type c) const override;
@@ -106,6 +117,10 @@ protected:
   template < class T >
   void read_column(const char *, T & val)
   {
+    if (block_fetch_) {
+      read_bound_column(val);
+      return;
+    }
     SQLLEN info = 0;
     SQLSMALLINT type = (SQLSMALLINT)mssql_statement::type2int(data_type_traits<T>::type());
     SQLRETURN ret = SQLGetData(stmt_, (SQLUSMALLINT)(result_index_++), type, &val, sizeof(T), &info);
@@ -127,6 +142,72 @@ protected:
 
   virtual bool finalize_fetch() override;
 
+private:
+  /*
+   * buffer of one column bound to the
+   * row array; holds the values of all
+   * rows of the current row set
+   */
+  struct column_buffer
+  {
+    SQLSMALLINT type = 0;
+    SQLLEN width = 0;
+    std::vector<char> data;
+    std::vector<SQLLEN> indicator;
+
+    const char* value(SQLULEN row) const
+    {
+      return data.data() + row * width;
+    }
+
+    bool is_null(SQLULEN row) const
+    {
+      return indicator[row] == SQL_NULL_DATA;
+    }
+  };
+
+  bool prepare_block_fetch();
+
+  const column_buffer* next_bound_column();
+
+  template < class T >
+  void read_bound_column(T &val)
+  {
+    const column_buffer *col = next_bound_column();
+    if (col == nullptr) {
+      return;
+    }
+    const char *data = col->value(row_index_);
+    switch (col->type) {
+      case SQL_C_SBIGINT:
+        val = (T)*reinterpret_cast<const SQLBIGINT*>(data);
+        break;
+      case SQL_C_DOUBLE:
+        val = (T)*reinterpret_cast<const SQLDOUBLE*>(data);
+        break;
+      case SQL_C_CHAR:
+        // numeric columns are bound as text
+        if (std::is_floating_point<T>::value) {
+          val = (T)std::strtod(data, nullptr);
+        } else if (std::is_signed<T>::value) {
+          val = (T)std::strtoll(data, nullptr, 10);
+        } else {
+          val = (T)std::strtoull(data, nullptr, 10);
+        }
+        break;
+      default:
+        throw_error("mssql", "invalid type of bound column");
+    }
+  }
+
+  void read_bound_column(char &val);
+  void read_bound_column(unsigned char &val);
+  void read_bound_column(char *val, size_t size);
+  void read_bound_column(std::string &val);
+  void read_bound_column(varchar_base &val);
+  void read_bound_column(oos::date &val);
+  void read_bound_column(oos::time &val);
+
 private:
   size_type affected_rows_ = 0;
   size_type rows = 0;
@@ -134,7 +215,19 @@ private:
   
   enum { NUMERIC_LEN = 21 };
 
+  // count of rows fetched at once
+  enum { ROW_ARRAY_SIZE = 64 };
+
+  // maximum width of a character column bound to
+  // the row array; longer columns are read row by row
+  enum { MAX_BOUND_WIDTH = 8000 };
+
   SQLHANDLE stmt_;
+
+  bool block_fetch_ = false;
+  std::vector<column_buffer> columns_;
+  SQLULEN rows_fetched_ = 0;
+  SQLULEN row_index_ = 0;
 };
 
 }
@@ -50,6 +50,14 @@ public:
   virtual void clear() override;
   virtual detail::result_impl* execute() override;
   virtual void reset() override;
+
+  /**
+   * The parameter sets are bound as column wise
+   * arrays and executed at once (SQL_ATTR_PARAMSET_SIZE).
+   *
+   * @return The maximum count of parameter sets
+   */
+  virtual std::size_t max_parameter_sets() const override;
   
 //  virtual int column_count() const;
 //  virtual const char* column_name(int i) const;
@@ -58,6 +66,8 @@ public:
   static int type2sql(data_type type);
 
 protected:
+  virtual void parameter_set(std::size_t set) override;
+
   virtual void serialize(const char*, char&) override;
   virtual void serialize(const char*, short&) override;
   virtual void serialize(const char*, int&) override;
@@ -86,14 +96,14 @@ protected:
       v->len = SQL_NULL_DATA;
     } else {
       v->data = new char[sizeof(T)];
+      v->size = sizeof(T);
       *static_cast<T*>(v->data) = val;
     }
     host_data_.push_back(v);
     
     SQLSMALLINT ctype = (SQLSMALLINT)mssql_statement::type2int(data_type_traits<T>::type());
     SQLSMALLINT type = (SQLSMALLINT)mssql_statement::type2sql(data_type_traits<T>::type());
-    SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, ctype, type, 0, 0, v->data, 0, NULL);
-    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+    bind_parameter((SQLUSMALLINT)index, ctype, type, 0, 0, v, 0, NULL);
   }
   void bind_value(char c, size_t index);
   void bind_value(unsigned char c, size_t index);
@@ -114,14 +124,19 @@ protected:
 
     int ctype = mssql_statement::type2int(data_type_traits<T>::type());
     int type = mssql_statement::type2sql(data_type_traits<T>::type());
-    SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, (SQLSMALLINT)ctype, (SQLSMALLINT)type, 0, 0, NULL, 0, NULL);
-    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind null parameter");
+    bind_parameter((SQLUSMALLINT)index, (SQLSMALLINT)ctype, (SQLSMALLINT)type, 0, 0, v, 0, NULL);
   }
 
 private:
+  struct value_t;
+
   void bind_null();
   void bind_value();
 
+  void bind_parameter(SQLUSMALLINT index, SQLSMALLINT ctype, SQLSMALLINT type, SQLULEN column_size, SQLSMALLINT digits, value_t *v, SQLLEN buffer_length, SQLLEN *len);
+  void bind_parameter_arrays();
+  void unbind_parameter_arrays();
+
   void create_statement();
 
 private:
@@ -130,10 +145,45 @@ private:
     ~value_t() { delete [] static_cast<char*>(data); }
     SQLLEN len;
     SQLLEN result_len = 0;
+    SQLLEN size = 0;
     void *data;
   };
   std::vector<value_t*> host_data_;
 
+  // a value bound to a parameter of a parameter set
+  struct set_parameter_t {
+    std::size_t set;
+    SQLUSMALLINT index;
+    SQLSMALLINT ctype;
+    SQLSMALLINT type;
+    SQLULEN column_size;
+    SQLSMALLINT digits;
+    value_t *value;
+  };
+  std::vector<set_parameter_t> set_parameters_;
+
+  // the values of all parameter sets of one parameter
+  struct parameter_array_t {
+    SQLSMALLINT ctype = 0;
+    SQLSMALLINT type = 0;
+    SQLULEN column_size = 0;
+    SQLSMALLINT digits = 0;
+    SQLLEN width = 0;
+    std::vector<char> data;
+    std::vector<SQLLEN> indicators;
+  };
+  std::vector<parameter_array_t> parameter_arrays_;
+
+  // count of bound parameter sets, zero
+  // while the parameters are bound directly
+  std::size_t parameter_sets_ = 0;
+  std::size_t current_set_ = 0;
+  // true while the statement handle binds
+  // parameter arrays of more than one set
+  bool parameter_arrays_bound_ = false;
+
+  enum { MAX_PARAMETER_SETS = 256 };
+
   enum { NUMERIC_LEN = 21 };
 
   bool bind_null_ = false;
@@ -22,13 +22,14 @@
 #include "tools/time.hpp"
 #include "tools/basic_identifier.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace oos {
 
 namespace mssql {
 
-mssql_result::mssql_result(SQLHANDLE stmt)
+mssql_result::mssql_result(SQLHANDLE stmt, bool block_fetch)
   : affected_rows_(0)
   , rows(0)
   , fields_(0)
@@ -46,10 +47,18 @@ mssql_result::mssql_result(SQLHANDLE stmt)
   SQLSMALLINT columns = 0;
   ret = SQLNumResultCols(stmt, &columns);
   throw_error(ret, SQL_HANDLE_STMT, stmt, "mssql", "couldn't get column count");
+  fields_ = (size_type)columns;
+
+  if (block_fetch) {
+    block_fetch_ = prepare_block_fetch();
+  }
 }
 
 mssql_result::~mssql_result()
 {
+  if (block_fetch_) {
+    SQLFreeStmt(stmt_, SQL_UNBIND);
+  }
   //std::cout << "closing statement handle " << stmt_ << "\n";
   SQLCloseCursor(stmt_);
   //std::cout << "freeing statement handle " << stmt_ << "\n";
@@ -70,6 +79,20 @@ bool mssql_result::fetch()
 //  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_CONCURRENCY, (void *) SQL_CONCUR_LOCK, SQL_NTS);
 //  throw_error(ret, SQL_HANDLE_DBC, stmt_, "mssql", "error on creating sql statement");
 
+  if (block_fetch_) {
+    // next row of the current row set
+    if (++row_index_ < rows_fetched_) {
+      return true;
+    }
+    SQLRETURN ret = SQLFetch(stmt_);
+    if (ret == SQL_NO_DATA) {
+      return false;
+    }
+    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "error on fetching next rows");
+    row_index_ = 0;
+    return rows_fetched_ > 0;
+  }
+
   SQLRETURN ret = SQLFetch(stmt_);
   if (SQL_SUCCEEDED(ret)) {
     return true;
@@ -156,6 +179,10 @@ void mssql_result::serialize(const char *id, double &x)
 
 void mssql_result::serialize(const char * /*id*/, char *x, size_t s)
 {
+  if (block_fetch_) {
+    read_bound_column(x, s);
+    return;
+  }
   SQLLEN info = 0;
   SQLRETURN ret = SQLGetData(stmt_, result_index_++, SQL_C_CHAR, x, s, &info);
   if (ret == SQL_SUCCESS) {
@@ -197,6 +224,10 @@ void mssql_result::serialize(const char *id, basic_identifier &x)
 
 void mssql_result::read_column(const char *, std::string &val)
 {
+  if (block_fetch_) {
+    read_bound_column(val);
+    return;
+  }
   char buf[1024];
   SQLLEN info = 0;
   SQLRETURN ret = SQLGetData(stmt_, result_index_++, SQL_C_CHAR, buf, 1024, &info);
@@ -209,6 +240,10 @@ void mssql_result::read_column(const char *, std::string &val)
 
 void mssql_result::read_column(const char *, char &val)
 {
+  if (block_fetch_) {
+    read_bound_column(val);
+    return;
+  }
   SQLLEN info = 0;
   SQLRETURN ret = SQLGetData(stmt_, (SQLUSMALLINT)(result_index_++), SQL_C_CHAR, &val, 0, &info);
   if (SQL_SUCCEEDED(ret)) {
@@ -220,6 +255,10 @@ void mssql_result::read_column(const char *, char &val)
 
 void mssql_result::read_column(const char *, varchar_base &val)
 {
+  if (block_fetch_) {
+    read_bound_column(val);
+    return;
+  }
   char *buf = new char[val.capacity()];
   SQLLEN info = 0;
   SQLRETURN ret = SQLGetData(stmt_, static_cast<SQLUSMALLINT>(result_index_++), SQL_C_CHAR, buf, val.capacity(), &info);
@@ -235,6 +274,10 @@ void mssql_result::read_column(const char *, varchar_base &val)
 
 void mssql_result::read_column(char const *, date &x)
 {
+  if (block_fetch_) {
+    read_bound_column(x);
+    return;
+  }
   SQL_DATE_STRUCT ds;
 
   SQLLEN info = 0;
@@ -250,6 +293,10 @@ void mssql_result::read_column(char const *, date &x)
 
 void mssql_result::read_column(char const *, time &x)
 {
+  if (block_fetch_) {
+    read_bound_column(x);
+    return;
+  }
   SQL_TIMESTAMP_STRUCT ts;
 
   SQLLEN info = 0;
@@ -261,6 +308,173 @@ void mssql_result::read_column(char const *, time &x)
   }
 }
 
+bool mssql_result::prepare_block_fetch()
+{
+  if (fields_ == 0) {
+    return false;
+  }
+  // choose a buffer for each column; if one
+  // column can't be bound all columns are
+  // read row by row with SQLGetData
+  std::vector<column_buffer> columns(fields_);
+  for (size_type i = 0; i < fields_; ++i) {
+    SQLSMALLINT type = 0;
+    SQLULEN size = 0;
+    SQLSMALLINT digits = 0;
+    SQLSMALLINT nullable = 0;
+    SQLRETURN ret = SQLDescribeCol(stmt_, (SQLUSMALLINT)(i + 1), nullptr, 0, nullptr, &type, &size, &digits, &nullable);
+    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't describe column");
+
+    column_buffer &col = columns[i];
+    switch (type) {
+      case SQL_BIT:
+      case SQL_TINYINT:
+      case SQL_SMALLINT:
+      case SQL_INTEGER:
+      case SQL_BIGINT:
+        col.type = SQL_C_SBIGINT;
+        col.width = sizeof(SQLBIGINT);
+        break;
+      case SQL_REAL:
+      case SQL_FLOAT:
+      case SQL_DOUBLE:
+        col.type = SQL_C_DOUBLE;
+        col.width = sizeof(SQLDOUBLE);
+        break;
+      case SQL_NUMERIC:
+      case SQL_DECIMAL:
+        col.type = SQL_C_CHAR;
+        col.width = NUMERIC_LEN + 2;
+        break;
+      case SQL_TYPE_DATE:
+        col.type = SQL_C_TYPE_DATE;
+        col.width = sizeof(SQL_DATE_STRUCT);
+        break;
+      case SQL_TYPE_TIMESTAMP:
+        col.type = SQL_C_TYPE_TIMESTAMP;
+        col.width = sizeof(SQL_TIMESTAMP_STRUCT);
+        break;
+      case SQL_CHAR:
+      case SQL_VARCHAR:
+        if (size == 0 || size > MAX_BOUND_WIDTH) {
+          return false;
+        }
+        col.type = SQL_C_CHAR;
+        col.width = (SQLLEN)size + 1;
+        break;
+      default:
+        return false;
+    }
+    col.data.resize(col.width * ROW_ARRAY_SIZE);
+    col.indicator.resize(ROW_ARRAY_SIZE);
+  }
+
+  SQLRETURN ret = SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER)SQL_BIND_BY_COLUMN, 0);
+  if (!SQL_SUCCEEDED(ret)) {
+    return false;
+  }
+  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)(SQLULEN)ROW_ARRAY_SIZE, 0);
+  if (!SQL_SUCCEEDED(ret)) {
+    return false;
+  }
+  // the driver may have chosen a smaller row set
+  SQLULEN row_array_size = 0;
+  ret = SQLGetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE, &row_array_size, 0, nullptr);
+  if (!SQL_SUCCEEDED(ret) || row_array_size == 0 || row_array_size > ROW_ARRAY_SIZE) {
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0);
+    return false;
+  }
+  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_ROWS_FETCHED_PTR, &rows_fetched_, 0);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't set rows fetched pointer");
+
+  // the buffers don't move anymore once bound
+  columns_ = std::move(columns);
+  for (size_type i = 0; i < fields_; ++i) {
+    column_buffer &col = columns_[i];
+    ret = SQLBindCol(stmt_, (SQLUSMALLINT)(i + 1), col.type, col.data.data(), col.width, col.indicator.data());
+    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind column");
+  }
+  return true;
+}
+
+const mssql_result::column_buffer* mssql_result::next_bound_column()
+{
+  // the result index starts at one
+  const column_buffer &col = columns_.at((size_type)(result_index_++ - 1));
+  if (col.is_null(row_index_)) {
+    return nullptr;
+  }
+  return &col;
+}
+
+void mssql_result::read_bound_column(char &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col != nullptr) {
+    val = col->value(row_index_)[0];
+  }
+}
+
+void mssql_result::read_bound_column(unsigned char &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col != nullptr) {
+    val = (unsigned char)col->value(row_index_)[0];
+  }
+}
+
+void mssql_result::read_bound_column(char *val, size_t size)
+{
+  const column_buffer *col = next_bound_column();
+  if (col == nullptr || size == 0) {
+    return;
+  }
+  size_t len = std::min(size - 1, (size_t)col->indicator[row_index_]);
+  memcpy(val, col->value(row_index_), len);
+  val[len] = '\0';
+}
+
+void mssql_result::read_bound_column(std::string &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col != nullptr) {
+    val.assign(col->value(row_index_), (size_t)col->indicator[row_index_]);
+  }
+}
+
+void mssql_result::read_bound_column(varchar_base &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col != nullptr) {
+    val.assign(col->value(row_index_), (size_t)col->indicator[row_index_]);
+  }
+}
+
+void mssql_result::read_bound_column(oos::date &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col == nullptr) {
+    return;
+  }
+  if (col->type == SQL_C_TYPE_TIMESTAMP) {
+    const SQL_TIMESTAMP_STRUCT *ts = reinterpret_cast<const SQL_TIMESTAMP_STRUCT*>(col->value(row_index_));
+    val.set(ts->day, ts->month, ts->year);
+  } else {
+    const SQL_DATE_STRUCT *ds = reinterpret_cast<const SQL_DATE_STRUCT*>(col->value(row_index_));
+    val.set(ds->day, ds->month, ds->year);
+  }
+}
+
+void mssql_result::read_bound_column(oos::time &val)
+{
+  const column_buffer *col = next_bound_column();
+  if (col == nullptr) {
+    return;
+  }
+  const SQL_TIMESTAMP_STRUCT *ts = reinterpret_cast<const SQL_TIMESTAMP_STRUCT*>(col->value(row_index_));
+  val.set(ts->year, ts->month, ts->day, ts->hour, ts->minute, ts->second, ts->fraction / 1000 / 1000);
+}
+
 bool mssql_result::prepare_fetch()
 {
   if (!fetch()) {
@@ -25,6 +25,7 @@
 #include "tools/identifiable_holder.hpp"
 #include "tools/basic_identifier.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 
@@ -51,20 +52,45 @@ mssql_statement::~mssql_statement()
 
 void mssql_statement::reset()
 {
+  if (parameter_arrays_bound_) {
+    unbind_parameter_arrays();
+  }
   while (!host_data_.empty()) {
     delete host_data_.back();
     host_data_.pop_back();
   }
+  set_parameters_.clear();
+  parameter_arrays_.clear();
+  parameter_sets_ = 0;
+  current_set_ = 0;
+}
+
+std::size_t mssql_statement::max_parameter_sets() const
+{
+  return MAX_PARAMETER_SETS;
+}
+
+void mssql_statement::parameter_set(std::size_t set)
+{
+  detail::statement_impl::parameter_set(set);
+  current_set_ = set;
+  parameter_sets_ = std::max(parameter_sets_, set + 1);
 }
 
 void mssql_statement::clear()
 {
+  // the handle is freed anyway
+  parameter_arrays_bound_ = false;
   reset();
   SQLFreeHandle(SQL_HANDLE_STMT, stmt_);
 }
 
 detail::result_impl* mssql_statement::execute()
 {
+  if (parameter_sets_ > 0) {
+    bind_parameter_arrays();
+  }
+
   SQLRETURN ret = SQLExecute(stmt_);
   // check if data is needed
   if (ret == SQL_NEED_DATA) {
@@ -74,7 +100,8 @@ detail::result_impl* mssql_statement::execute()
     throw_error(ret, SQL_HANDLE_STMT, stmt_, str(), "error on query execute");
   }
 
-  mssql_result *res = new mssql_result(stmt_);
+  // rows of prepared statements are fetched as arrays
+  mssql_result *res = new mssql_result(stmt_, true);
 
   create_statement();
 
@@ -187,14 +214,14 @@ void mssql_statement::bind_value(char c, size_t index)
   } else {
     v->len = sizeof(char);
     v->data = new char[1];
+    v->size = 1;
     *static_cast<char*>(v->data) = c;
   }
   host_data_.push_back(v);
 
   SQLUSMALLINT ctype = (SQLUSMALLINT)mssql_statement::type2int(data_type_traits<char>::type());
   SQLUSMALLINT type = (SQLUSMALLINT)mssql_statement::type2sql(data_type_traits<char>::type());
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, ctype, type, 1, 0, v->data, v->len, &v->len);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, ctype, type, 1, 0, v, v->len, &v->len);
 }
 
 void mssql_statement::bind_value(unsigned char c, size_t index)
@@ -206,14 +233,14 @@ void mssql_statement::bind_value(unsigned char c, size_t index)
   } else {
     v->len = sizeof(unsigned char);
     v->data = new char[1];
+    v->size = 1;
     *static_cast<unsigned char*>(v->data) = c;
   }
   host_data_.push_back(v);
 
   SQLUSMALLINT ctype = (SQLUSMALLINT)mssql_statement::type2int(data_type_traits<unsigned char>::type());
   SQLUSMALLINT type = (SQLUSMALLINT)mssql_statement::type2sql(data_type_traits<unsigned char>::type());
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, ctype, type, 1, 0, v->data, v->len, &v->len);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, ctype, type, 1, 0, v, v->len, &v->len);
 }
 
 void mssql_statement::bind_value(bool val, size_t index)
@@ -225,14 +252,14 @@ void mssql_statement::bind_value(bool val, size_t index)
   }
   else {
     v->data = new char[sizeof(unsigned short)];
+    v->size = sizeof(unsigned short);
     *static_cast<unsigned short*>(v->data) = (unsigned short)val;
   }
   host_data_.push_back(v);
 
   SQLSMALLINT ctype = (SQLSMALLINT)mssql_statement::type2int(data_type_traits<bool>::type());
   SQLSMALLINT type = (SQLSMALLINT)mssql_statement::type2sql(data_type_traits<bool>::type());
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, ctype, type, 0, 0, v->data, 0, NULL);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, ctype, type, 0, 0, v, 0, NULL);
 }
 
 void mssql_statement::bind_value(const oos::date &d, size_t index)
@@ -244,6 +271,7 @@ void mssql_statement::bind_value(const oos::date &d, size_t index)
     v->len = SQL_NULL_DATA;
   } else {
     v->data = new char[sizeof(SQL_DATE_STRUCT)];
+    v->size = sizeof(SQL_DATE_STRUCT);
     v->len = sizeof(SQL_DATE_STRUCT);
 
     SQL_DATE_STRUCT *ts = static_cast<SQL_DATE_STRUCT *>(v->data);
@@ -253,8 +281,7 @@ void mssql_statement::bind_value(const oos::date &d, size_t index)
     ts->day = (SQLUSMALLINT) d.day();
   }
 
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, SQL_C_TYPE_DATE, SQL_TYPE_TIMESTAMP, 10, 0, v->data, 0, &v->len);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, SQL_C_TYPE_DATE, SQL_TYPE_TIMESTAMP, 10, 0, v.get(), 0, &v->len);
 
   host_data_.push_back(v.release());
 }
@@ -268,6 +295,7 @@ void mssql_statement::bind_value(const oos::time &t, size_t index)
     v->len = SQL_NULL_DATA;
   } else {
     v->data = new char[sizeof(SQL_TIMESTAMP_STRUCT)];
+    v->size = sizeof(SQL_TIMESTAMP_STRUCT);
     v->len = sizeof(SQL_TIMESTAMP_STRUCT);
 
     SQL_TIMESTAMP_STRUCT *ts = static_cast<SQL_TIMESTAMP_STRUCT *>(v->data);
@@ -281,9 +309,7 @@ void mssql_statement::bind_value(const oos::time &t, size_t index)
     ts->fraction = (SQLUINTEGER) t.milli_second() * 1000 * 1000;
   }
 
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP, 23, 3, v->data, 0, &v->len);
-
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP, 23, 3, v.get(), 0, &v->len);
 
   host_data_.push_back(v.release());
 }
@@ -296,12 +322,12 @@ void mssql_statement::bind_value(unsigned long val, size_t index)
     v->len = SQL_NULL_DATA;
   } else {
     v->data = new char[sizeof(unsigned long)];
+    v->size = sizeof(unsigned long);
     *static_cast<unsigned long*>(v->data) = val;
   }
   host_data_.push_back(v);
 
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, SQL_C_ULONG, SQL_BIGINT, 0, 0, v->data, 0, NULL);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, SQL_C_ULONG, SQL_BIGINT, 0, 0, v, 0, NULL);
 }
 
 void mssql_statement::bind_value(const char *val, size_t size, size_t index)
@@ -314,6 +340,8 @@ void mssql_statement::bind_value(const char *val, size_t size, size_t index)
   } else {
 
     v->data = new char[size];
+
+    v->size = size;
 #ifdef _MSC_VER
 	strcpy_s((char *) v->data, size, val);
 #else
@@ -323,8 +351,7 @@ void mssql_statement::bind_value(const char *val, size_t size, size_t index)
 
   host_data_.push_back(v);
 
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_LONGVARCHAR, size, 0, v->data, v->len, NULL);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, SQL_C_CHAR, SQL_LONGVARCHAR, size, 0, v, v->len, NULL);
 }
 
 void mssql_statement::bind_value(const std::string &str, size_t index)
@@ -338,6 +365,8 @@ void mssql_statement::bind_value(const std::string &str, size_t index)
   } else {
 
     v->data = new char[s + 1];
+
+    v->size = s + 1;
 #ifdef _MSC_VER
     strncpy_s((char *)v->data, s + 1, str.c_str(), s);
 #else
@@ -348,8 +377,7 @@ void mssql_statement::bind_value(const std::string &str, size_t index)
 
   host_data_.push_back(v);
 
-  SQLRETURN ret = SQLBindParameter(stmt_, (SQLUSMALLINT)index, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_LONGVARCHAR, str.size(), 0, v->data, str.size(), &v->result_len);
-  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+  bind_parameter((SQLUSMALLINT)index, SQL_C_CHAR, SQL_LONGVARCHAR, str.size(), 0, v, str.size(), &v->result_len);
 }
 
 int mssql_statement::type2int(data_type type)
@@ -436,6 +464,84 @@ int mssql_statement::type2sql(data_type type)
     }
 }
 
+void mssql_statement::bind_parameter(SQLUSMALLINT index, SQLSMALLINT ctype, SQLSMALLINT type, SQLULEN column_size, SQLSMALLINT digits, value_t *v, SQLLEN buffer_length, SQLLEN *len)
+{
+  if (parameter_sets_ > 0) {
+    // the values of all sets are bound
+    // as arrays before execution
+    set_parameters_.push_back({current_set_, index, ctype, type, column_size, digits, v});
+    return;
+  }
+  SQLRETURN ret = SQLBindParameter(stmt_, index, SQL_PARAM_INPUT, ctype, type, column_size, digits, v->data, buffer_length, len);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter");
+}
+
+void mssql_statement::bind_parameter_arrays()
+{
+  // the elements of a parameter array are as
+  // wide as the widest value of the parameter
+  std::size_t params = 0;
+  for (const set_parameter_t &p : set_parameters_) {
+    params = std::max<std::size_t>(params, p.index);
+  }
+  parameter_arrays_.assign(params, parameter_array_t());
+  std::vector<std::vector<const value_t*>> values(params, std::vector<const value_t*>(parameter_sets_, nullptr));
+  for (const set_parameter_t &p : set_parameters_) {
+    parameter_array_t &array = parameter_arrays_[p.index - 1];
+    array.ctype = p.ctype;
+    array.type = p.type;
+    array.column_size = std::max(array.column_size, p.column_size);
+    array.digits = p.digits;
+    array.width = std::max(array.width, p.value->size);
+    values[p.index - 1][p.set] = p.value;
+  }
+
+  SQLRETURN ret = SQLSetStmtAttr(stmt_, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameters by column");
+  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)parameter_sets_, 0);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't set parameter set size");
+  parameter_arrays_bound_ = true;
+
+  for (std::size_t i = 0; i < params; ++i) {
+    parameter_array_t &array = parameter_arrays_[i];
+    // a parameter must have at least one byte
+    array.width = std::max<SQLLEN>(array.width, 1);
+    array.data.assign(parameter_sets_ * (std::size_t)array.width, 0);
+    array.indicators.assign(parameter_sets_, SQL_NULL_DATA);
+    for (std::size_t set = 0; set < parameter_sets_; ++set) {
+      const value_t *v = values[i][set];
+      if (v == nullptr || v->data == nullptr) {
+        continue;
+      }
+      const char *data = static_cast<const char*>(v->data);
+      char *element = &array.data[set * (std::size_t)array.width];
+      std::copy(data, data + v->size, element);
+      if (array.ctype == SQL_C_CHAR) {
+        // character values are passed with their
+        // length, they aren't null terminated
+        array.indicators[set] = std::find(data, data + v->size, '\0') - data;
+      } else {
+        array.indicators[set] = v->size;
+      }
+    }
+    ret = SQLBindParameter(stmt_, (SQLUSMALLINT)(i + 1), SQL_PARAM_INPUT, array.ctype, array.type, array.column_size, array.digits, array.data.data(), array.width, array.indicators.data());
+    throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameter array");
+  }
+}
+
+void mssql_statement::unbind_parameter_arrays()
+{
+  // the next execution binds a single
+  // parameter set to the host values
+  parameter_arrays_bound_ = false;
+  SQLRETURN ret = SQLFreeStmt(stmt_, SQL_RESET_PARAMS);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't reset parameters");
+  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't set parameter set size");
+  ret = SQLSetStmtAttr(stmt_, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "couldn't bind parameters by column");
+}
+
 void mssql_statement::bind_null()
 {
   bind_null_ = true;
@@ -454,6 +560,7 @@ void mssql_statement::create_statement()
 
   ret = SQLPrepare(stmt_, (SQLCHAR*)str().c_str(), SQL_NTS);
   throw_error(ret, SQL_HANDLE_STMT, stmt_, str());
+  parameter_arrays_bound_ = false;
 }
 
 }
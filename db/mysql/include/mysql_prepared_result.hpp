@@ -27,6 +27,8 @@ class date;
 
 namespace mysql {
 
+class mysql_statement;
+
 class mysql_prepared_result : public detail::result_impl
 {
 private:
@@ -38,9 +40,15 @@ public:
   typedef std::unordered_map<std::string, std::shared_ptr<basic_identifier> > t_pk_map;
 
 public:
-  mysql_prepared_result(MYSQL_STMT *s, int rs);
+  mysql_prepared_result(MYSQL_STMT *s, mysql_result_info *info, int rs, mysql_statement *owner = nullptr);
   ~mysql_prepared_result();
 
+  /**
+   * Discards the unread rows of a streamed
+   * result. Any further fetch returns false.
+   */
+  void discard();
+
   virtual const char* column(size_type c) const override;
   virtual bool fetch() override;
 
@@ -95,6 +103,9 @@ private:
   void prepare_bind_column(int index, enum_field_types type, char *x, size_t s);
   void prepare_bind_column(int index, enum_field_types type, varchar_base &value);
 
+  void reserve_buffer(int index, unsigned long size);
+  void fetch_string(int index, std::string &value);
+
 private:
   int column_index_ = 0;
   size_type affected_rows_;
@@ -103,12 +114,19 @@ private:
   MYSQL_STMT *stmt;
   int result_size;
   MYSQL_BIND *bind_;
-  mysql_result_info *info_;
+  mysql_result_info *info_; // owned by the statement
 
   t_pk_map pk_map_;
 
   bool prepare_binding_ = true;
 
+  // rows aren't stored on the client; rows
+  // counts the rows fetched so far
+  bool streamed_ = false;
+  // statement of a streamed result
+  // while its rows are pending
+  mysql_statement *owner_ = nullptr;
+
   typedef std::unordered_map<std::string, std::shared_ptr<basic_identifier> > t_foreign_key_map;
   t_foreign_key_map foreign_keys_;
 };
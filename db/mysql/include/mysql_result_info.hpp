@@ -18,6 +18,7 @@ struct mysql_result_info
   my_bool error;
   char *buffer;
   unsigned long buffer_length;
+  unsigned long column_length; // maximum length of the column from the result metadata
 };
 
 }
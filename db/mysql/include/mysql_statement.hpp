@@ -29,6 +29,8 @@
 #include <mysql/mysql.h>
 #endif
 
+#include "mysql_result_info.hpp"
+
 #include <string>
 #include <vector>
 #include <type_traits>
@@ -43,6 +45,7 @@ class date;
 namespace mysql {
 
 class mysql_connection;
+class mysql_prepared_result;
 
 class mysql_statement : public oos::detail::statement_impl
 {
@@ -92,12 +95,28 @@ private:
   void bind_value(MYSQL_BIND &bind, enum_field_types type, size_t index);
   void bind_value(MYSQL_BIND &bind, enum_field_types type, const char *value, size_t size, size_t index);
 
+  void prepare_result_info();
+
+  friend class mysql_prepared_result;
+
+  void discard_streamed_result();
+  void release_streamed_result(mysql_prepared_result *result);
+
 private:
   size_t result_size;
   size_t host_size;
   std::vector<unsigned long> length_vector;
+  std::vector<unsigned long> capacity_vector;
   MYSQL_STMT *stmt_ = nullptr;
   MYSQL_BIND *host_array = nullptr;
+
+  // the column buffers are kept for all
+  // results of the statement and only grow
+  mysql_result_info *result_info_ = nullptr;
+
+  // the streamed result with pending rows; it
+  // must be discarded before the next execution
+  mysql_prepared_result *streamed_result_ = nullptr;
 };
 
 }
@@ -1,5 +1,6 @@
 #include "mysql_prepared_result.hpp"
 #include "mysql_exception.hpp"
+#include "mysql_statement.hpp"
 
 #include "tools/date.hpp"
 #include "tools/time.hpp"
@@ -7,34 +8,53 @@
 #include "tools/basic_identifier.hpp"
 #include "tools/identifiable_holder.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace oos {
 
 namespace mysql {
 
-mysql_prepared_result::mysql_prepared_result(MYSQL_STMT *s, int rs)
+namespace {
+
+// maximum size of a string column buffer; longer
+// values are fetched piece by piece
+const unsigned long MAX_BUFFER_SIZE = 16384;
+
+}
+
+mysql_prepared_result::mysql_prepared_result(MYSQL_STMT *s, mysql_result_info *info, int rs, mysql_statement *owner)
   : affected_rows_((size_type)mysql_stmt_affected_rows(s))
-  , rows((size_type)mysql_stmt_num_rows(s))
+  , rows(owner != nullptr ? 0 : (size_type)mysql_stmt_num_rows(s))
   , fields_(mysql_stmt_field_count(s))
   , stmt(s)
   , result_size(rs)
   , bind_(new MYSQL_BIND[rs])
-  , info_(new mysql_result_info[rs])
+  , info_(info)
+  , streamed_(owner != nullptr)
+  , owner_(owner)
 {
     memset(bind_, 0, rs * sizeof(MYSQL_BIND));
-    memset(info_, 0, rs * sizeof(mysql_result_info));
 }
 
 mysql_prepared_result::~mysql_prepared_result()
 {
+  if (owner_ != nullptr) {
+    // discard the rows not read yet, otherwise
+    // the connection can't execute anything else
+    mysql_stmt_free_result(stmt);
+    owner_->release_streamed_result(this);
+  }
   delete [] bind_;
-  for (int i = 0; i < result_size; ++i) {
-    if (info_[i].buffer != 0) {
-      delete [] info_[i].buffer;
-    }
+}
+
+void mysql_prepared_result::discard()
+{
+  if (owner_ == nullptr) {
+    return;
   }
-  delete [] info_;
+  mysql_stmt_free_result(stmt);
+  owner_ = nullptr;
 }
 
 const char* mysql_prepared_result::column(size_type ) const
@@ -45,6 +65,20 @@ const char* mysql_prepared_result::column(size_type ) const
 bool mysql_prepared_result::fetch()
 {
   // get next row
+  if (streamed_) {
+    if (owner_ == nullptr) {
+      // rows were discarded
+      return false;
+    }
+    int ret = mysql_stmt_fetch(stmt);
+    if (ret == MYSQL_NO_DATA) {
+      return false;
+    } else if (ret == 1) {
+      throw_stmt_error(ret, stmt, "mysql", "");
+    }
+    ++rows;
+    return true;
+  }
   int ret = mysql_stmt_fetch(stmt);
   if (ret == MYSQL_DATA_TRUNCATED) {
     // Todo: handle truncated data
@@ -56,6 +90,10 @@ bool mysql_prepared_result::prepare_fetch()
 {
   // reset result column index
   result_index_ = 0;
+  if (streamed_ && owner_ == nullptr) {
+    // rows were discarded
+    return false;
+  }
   // fetch data
   int ret = mysql_stmt_fetch(stmt);
   if (ret == MYSQL_NO_DATA) {
@@ -63,6 +101,9 @@ bool mysql_prepared_result::prepare_fetch()
   } else if (ret == 1) {
     throw_stmt_error(ret, stmt, "mysql", "");
   }
+  if (streamed_) {
+    ++rows;
+  }
   prepare_binding_ = false;
   return true;
 }
@@ -253,17 +294,7 @@ void mysql_prepared_result::serialize(const char */*id*/, std::string &x)
     prepare_bind_column(column_index_++, MYSQL_TYPE_STRING, x);
   } else {
     if (info_[result_index_].length > 0) {
-      bind_[result_index_].buffer = new char[info_[result_index_].length];
-      bind_[result_index_].buffer_length = info_[result_index_].length;
-      if (mysql_stmt_fetch_column(stmt, &bind_[result_index_], result_index_, 0) != 0) {
-        // an error occured
-      } else {
-        char *data = (char*)bind_[result_index_].buffer;
-        unsigned long len = bind_[result_index_].buffer_length;
-        x.assign(data, len);
-      }
-      delete [] (char*)bind_[result_index_].buffer;
-      bind_[result_index_].buffer = 0;
+      fetch_string(result_index_, x);
     }
     ++result_index_;
   }
@@ -319,12 +350,7 @@ bool mysql_prepared_result::finalize_bind()
 
 void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type, oos::date &)
 {
-  if (info_[index].buffer == 0) {
-    size_t s = sizeof(MYSQL_TIME);
-    info_[index].buffer = new char[s];
-    memset(info_[index].buffer, 0, s);
-    info_[index].buffer_length = s;
-  }
+  reserve_buffer(index, sizeof(MYSQL_TIME));
   bind_[index].buffer_type = type;
   bind_[index].buffer = info_[index].buffer;
   bind_[index].buffer_length = info_[index].buffer_length;
@@ -335,12 +361,7 @@ void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type
 
 void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type, oos::time &)
 {
-  if (info_[index].buffer == 0) {
-    size_t s = sizeof(MYSQL_TIME);
-    info_[index].buffer = new char[s];
-    memset(info_[index].buffer, 0, s);
-    info_[index].buffer_length = s;
-  }
+  reserve_buffer(index, sizeof(MYSQL_TIME));
   bind_[index].buffer_type = type;
   bind_[index].buffer = info_[index].buffer;
   bind_[index].buffer_length = info_[index].buffer_length;
@@ -351,9 +372,12 @@ void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type
 
 void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type, std::string & /*value*/)
 {
+  // values fitting into the buffer are fetched
+  // with the row, longer ones in fetch_string()
+  reserve_buffer(index, std::min(info_[index].column_length, MAX_BUFFER_SIZE));
   bind_[index].buffer_type = type;
-  bind_[index].buffer = nullptr;
-  bind_[index].buffer_length = 0;
+  bind_[index].buffer = info_[index].buffer;
+  bind_[index].buffer_length = info_[index].buffer_length;
   bind_[index].is_null = &info_[index].is_null;
   bind_[index].length = &info_[index].length;
   bind_[index].error = &info_[index].error;
@@ -371,11 +395,7 @@ void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type
 
 void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type, varchar_base &x)
 {
-  if (info_[index].buffer == nullptr) {
-    info_[index].buffer = new char[x.capacity()];
-    memset(info_[index].buffer, 0, x.capacity());
-    info_[index].buffer_length = x.capacity();
-  }
+  reserve_buffer(index, x.capacity());
   bind_[index].buffer_type = type;
   bind_[index].buffer = info_[index].buffer;
   bind_[index].buffer_length = info_[index].buffer_length;
@@ -384,6 +404,48 @@ void mysql_prepared_result::prepare_bind_column(int index, enum_field_types type
   bind_[index].error = &info_[index].error;
 }
 
+void mysql_prepared_result::reserve_buffer(int index, unsigned long size)
+{
+  mysql_result_info &info = info_[index];
+  if (info.buffer != nullptr && info.buffer_length >= size) {
+    return;
+  }
+  delete [] info.buffer;
+  info.buffer = new char[size > 0 ? size : 1];
+  memset(info.buffer, 0, size > 0 ? size : 1);
+  info.buffer_length = size;
+}
+
+void mysql_prepared_result::fetch_string(int index, std::string &value)
+{
+  mysql_result_info &info = info_[index];
+  unsigned long length = info.length;
+  if (length <= info.buffer_length) {
+    value.assign(info.buffer, length);
+    return;
+  }
+  // the value was truncated: keep the fetched part
+  // and fetch the rest directly into the string. the
+  // bound buffer must stay as it is, the statement
+  // writes the following rows into it
+  value.assign(info.buffer, info.buffer_length);
+  unsigned long offset = (unsigned long)value.size();
+  value.resize(length);
+
+  MYSQL_BIND piece;
+  memset(&piece, 0, sizeof(MYSQL_BIND));
+  unsigned long piece_length = 0;
+  piece.buffer_type = bind_[index].buffer_type;
+  piece.buffer = &value[offset];
+  piece.buffer_length = length - offset;
+  piece.length = &piece_length;
+
+  int ret = mysql_stmt_fetch_column(stmt, &piece, (unsigned int)index, offset);
+  if (ret != 0) {
+    throw_stmt_error(ret, stmt, "mysql", "");
+  }
+}
+
 }
 
 }
@@ -27,6 +27,7 @@
 
 #include "sql/sql.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace oos {
@@ -47,12 +48,15 @@ mysql_statement::mysql_statement(mysql_connection &db, const oos::sql &stmt)
     host_array = new MYSQL_BIND[host_size];
     memset(host_array, 0, host_size * sizeof(MYSQL_BIND));
     length_vector.assign(host_size, 0);
+    capacity_vector.assign(host_size, 0);
   }
 
   int res = mysql_stmt_prepare(stmt_, str().c_str(), str().size());
   if (res > 0) {
     throw_stmt_error(res, stmt_, "mysql", str());
   }
+
+  prepare_result_info();
 }
 
 mysql_statement::~mysql_statement()
@@ -63,11 +67,13 @@ mysql_statement::~mysql_statement()
 
 void mysql_statement::reset()
 {
+  discard_streamed_result();
   mysql_stmt_reset(stmt_);
 }
 
 void mysql_statement::clear()
 {
+  discard_streamed_result();
   for (size_t i = 0; i < host_size; ++i) {
     if (host_array[i].buffer) {
       delete [] static_cast<char*>(host_array[i].buffer);
@@ -75,6 +81,14 @@ void mysql_statement::clear()
   }
   delete [] host_array;
   host_array = nullptr;
+  length_vector.clear();
+  capacity_vector.clear();
+
+  for (size_t i = 0; i < result_size; ++i) {
+    delete [] result_info_[i].buffer;
+  }
+  delete [] result_info_;
+  result_info_ = nullptr;
 
   result_size = 0;
   host_size = 0;
@@ -83,6 +97,11 @@ void mysql_statement::clear()
 
 detail::result_impl* mysql_statement::execute()
 {
+  // executing again discards the pending rows of
+  // the last streamed result, so it must not
+  // free the rows of the new result later
+  discard_streamed_result();
+
   if (host_array) {
     int res = mysql_stmt_bind_param(stmt_, host_array);
     if (res > 0) {
@@ -95,11 +114,53 @@ detail::result_impl* mysql_statement::execute()
   if (res > 0) {
     throw_stmt_error(res, stmt_, "mysql", str());
   }
+  if (result_mode() == t_result_mode::STREAMED) {
+    // rows are fetched from the server one by one
+    streamed_result_ = new mysql_prepared_result(stmt_, result_info_, (int)result_size, this);
+    return streamed_result_;
+  }
   res = mysql_stmt_store_result(stmt_);
   if (res > 0) {
     throw_stmt_error(res, stmt_, "mysql", str());
   }
-  return new mysql_prepared_result(stmt_, (int)result_size);
+  return new mysql_prepared_result(stmt_, result_info_, (int)result_size);
+}
+
+void mysql_statement::discard_streamed_result()
+{
+  if (streamed_result_ != nullptr) {
+    streamed_result_->discard();
+    streamed_result_ = nullptr;
+  }
+}
+
+void mysql_statement::release_streamed_result(mysql_prepared_result *result)
+{
+  if (streamed_result_ == result) {
+    streamed_result_ = nullptr;
+  }
+}
+
+void mysql_statement::prepare_result_info()
+{
+  if (result_size == 0) {
+    return;
+  }
+  result_info_ = new mysql_result_info[result_size];
+  memset(result_info_, 0, result_size * sizeof(mysql_result_info));
+
+  // the column lengths are used to size
+  // the buffers of the string columns
+  MYSQL_RES *metadata = mysql_stmt_result_metadata(stmt_);
+  if (metadata == nullptr) {
+    return;
+  }
+  size_t count = std::min<size_t>(mysql_num_fields(metadata), result_size);
+  MYSQL_FIELD *fields = mysql_fetch_fields(metadata);
+  for (size_t i = 0; i < count; ++i) {
+    result_info_[i].column_length = fields[i].length;
+  }
+  mysql_free_result(metadata);
 }
 
 void mysql_statement::serialize(const char *, char &x)
@@ -215,6 +276,9 @@ void mysql_statement::serialize(const char *id, identifiable_holder &x, cascade_
 {
   if (x.has_primary_key()) {
     x.primary_key()->serialize(id, *this);
+  } else {
+    host_array[host_index].buffer_type = MYSQL_TYPE_NULL;
+    ++host_index;
   }
 }
 
@@ -271,17 +335,14 @@ void mysql_statement::bind_value(MYSQL_BIND &bind, enum_field_types type, size_t
   bind.is_null = 0;
 }
 
-void mysql_statement::bind_value(MYSQL_BIND &bind, enum_field_types type, const char *value, size_t size, size_t /*index*/)
+void mysql_statement::bind_value(MYSQL_BIND &bind, enum_field_types type, const char *value, size_t size, size_t index)
 {
-  if (bind.buffer_length < size) {
-    // reallocate memory
+  // the buffer only grows, so rebinding a
+  // value of the same or smaller size reuses it
+  if (bind.buffer == nullptr || capacity_vector.at(index) < size) {
     delete [] static_cast<char*>(bind.buffer);
-    bind.buffer = nullptr;
-    bind.buffer_length = 0;
-  }
-  if (bind.buffer == nullptr) {
-    // allocating memory
-    bind.buffer = new char[size];
+    bind.buffer = new char[size > 0 ? size : 1];
+    capacity_vector[index] = (unsigned long)size;
   }
   bind.buffer_length = (unsigned long)size;
 #ifdef WIN32
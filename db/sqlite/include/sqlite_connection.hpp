@@ -36,6 +36,7 @@
 #include "sql/result_impl.hpp"
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace oos {
   
@@ -95,7 +96,7 @@ public:
   sqlite3* handle();
 
 private:
-  static int parse_result(void* param, int column_count, char** values, char** columns);
+  int step(sqlite3_stmt *stmt, bool to_completion);
 
 private:
   sqlite3 *sqlite_db_;
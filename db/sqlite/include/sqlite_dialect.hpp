@@ -17,6 +17,28 @@ public:
 
   const char* type_string(oos::data_type type) const;
   data_type string_type(const char *type) const;
+
+  /**
+   * Enables the integer storage of dates and times.
+   * Then a date is stored as integer julian day in a
+   * DATE column and a time as integer microseconds
+   * since epoch in a TIMESTAMP column. Otherwise both
+   * are stored as ISO 8601 text in TEXT columns.
+   *
+   * @param enable True to store dates and times as integers
+   */
+  void integer_date_time(bool enable);
+
+  /**
+   * Returns true if dates and times
+   * are stored as integers.
+   *
+   * @return True if dates and times are stored as integers
+   */
+  bool integer_date_time() const;
+
+private:
+  bool integer_date_time_ = false;
 };
 
 }
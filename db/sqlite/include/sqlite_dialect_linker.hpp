@@ -0,0 +1,28 @@
+#ifndef OOS_SQLITE_DIALECT_LINKER_HPP
+#define OOS_SQLITE_DIALECT_LINKER_HPP
+
+#include "sql/basic_dialect_linker.hpp"
+
+namespace oos {
+
+namespace sqlite {
+
+/**
+ * With integer date and time storage the sqlite
+ * linker writes date and time values of direct
+ * statements in the same integer form as the
+ * prepared statements bind them.
+ */
+class sqlite_dialect_linker : public detail::basic_dialect_linker
+{
+public:
+  virtual ~sqlite_dialect_linker() {}
+
+  virtual void visit(const oos::detail::basic_value &val) override;
+};
+
+}
+
+}
+
+#endif //OOS_SQLITE_DIALECT_LINKER_HPP
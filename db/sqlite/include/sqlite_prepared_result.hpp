@@ -21,7 +21,19 @@ public:
   typedef oos::detail::result_impl::size_type size_type;
 
 public:
-  sqlite_prepared_result(sqlite3_stmt *stmt, int rs);
+  /**
+   * Creates a result streaming the rows of the
+   * given statement. If the result owns the
+   * statement it is finalized on destruction.
+   * Once the last row is read the statement is
+   * reset, so it doesn't hold its read lock
+   * until the result is destroyed.
+   *
+   * @param stmt The statement to fetch the rows from
+   * @param rs The return code of the first sqlite3_step
+   * @param owns_stmt True if the result finalizes the statement
+   */
+  sqlite_prepared_result(sqlite3_stmt *stmt, int rs, bool owns_stmt = false);
   virtual ~sqlite_prepared_result();
 
   virtual const char *column(size_type c) const override;
@@ -57,9 +69,17 @@ protected:
   virtual void serialize(const char *id, basic_identifier &x) override;
   virtual void serialize(const char *id, identifiable_holder&x, cascade_type) override;
 
+private:
+  bool next_row();
+  void step();
+  void release();
+
 private:
   int ret_;
-  bool first_;
+  // true if ret_ holds the state of a
+  // row which isn't consumed yet
+  bool stepped_;
+  bool owns_stmt_;
   size_type rows;
   size_type fields_;
   sqlite3_stmt *stmt_;
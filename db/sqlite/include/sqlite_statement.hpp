@@ -65,11 +65,12 @@ protected:
   virtual void serialize(const char *id, basic_identifier &x);
   virtual void serialize(const char *id, identifiable_holder&x, cascade_type);
 
+private:
+  bool integer_date_time() const;
+
 private:
   sqlite_connection &db_;
   sqlite3_stmt *stmt_;
-
-  std::vector<std::shared_ptr<std::string> > host_strings_;
 };
 
 }
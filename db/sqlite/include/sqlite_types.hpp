@@ -20,6 +20,9 @@
 
 #include "sqlite_statement.hpp"
 
+#include "tools/date.hpp"
+#include "tools/time.hpp"
+
 namespace oos {
 
 class varchar_base;
@@ -48,6 +51,41 @@ template <> struct type_traits<oos::date> { inline static const char* type_strin
 template <> struct type_traits<oos::time> { inline static const char* type_string() { return "TEXT"; } };
 template <> struct type_traits<object_base_ptr> { inline static const char* type_string() { return "INTEGER"; } };
 
+/**
+ * Returns the microseconds since epoch
+ * of the given time. That is the form a
+ * time is stored in with integer storage.
+ *
+ * @param x The time to convert
+ * @return The microseconds since epoch
+ */
+inline long long to_microseconds(const oos::time &x)
+{
+  struct timeval tv = x.get_timeval();
+  return (long long)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/**
+ * Creates a time from the given
+ * microseconds since epoch.
+ *
+ * @param usec The microseconds since epoch
+ * @return The created time
+ */
+inline oos::time from_microseconds(long long usec)
+{
+  long long sec = usec / 1000000LL;
+  long long rest = usec % 1000000LL;
+  if (rest < 0) {
+    rest += 1000000LL;
+    --sec;
+  }
+  struct timeval tv;
+  tv.tv_sec = (decltype(tv.tv_sec))sec;
+  tv.tv_usec = (decltype(tv.tv_usec))rest;
+  return oos::time(tv);
+}
+
 class sqlite_types
 {
 public:
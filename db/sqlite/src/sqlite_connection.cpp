@@ -17,7 +17,7 @@
 
 #include "sqlite_connection.hpp"
 #include "sqlite_statement.hpp"
-#include "sqlite_result.hpp"
+#include "sqlite_prepared_result.hpp"
 #include "sqlite_types.hpp"
 #include "sqlite_exception.hpp"
 
@@ -54,10 +54,30 @@ sqlite_connection::~sqlite_connection()
 
 void sqlite_connection::open(const std::string &db)
 {
-  int ret = sqlite3_open(db.c_str(), &sqlite_db_);
+  // the database file may be followed by the
+  // storage option of dates and times, i.e.
+  // "test.sqlite?date_time=integer"
+  std::string file(db);
+  std::string::size_type pos = db.find('?');
+  if (pos != std::string::npos) {
+    file = db.substr(0, pos);
+    std::string option(db.substr(pos + 1));
+    if (option == "date_time=integer") {
+      dialect_.integer_date_time(true);
+    } else if (option == "date_time=text") {
+      dialect_.integer_date_time(false);
+    } else {
+      throw sqlite_exception("unknown sqlite option: " + option);
+    }
+  }
+  int ret = sqlite3_open(file.c_str(), &sqlite_db_);
   if (ret != SQLITE_OK) {
-    throw sqlite_exception("couldn't open sql: " + db);
+    throw sqlite_exception("couldn't open sql: " + file);
   }
+  // with more than one connection to the database
+  // (i.e. pooled ones) wait for the lock of another
+  // connection instead of failing at once
+  sqlite3_busy_timeout(sqlite_db_, 5000);
 }
 
 bool sqlite_connection::is_open() const
@@ -67,7 +87,9 @@ bool sqlite_connection::is_open() const
 
 void sqlite_connection::close()
 {
-  int ret = sqlite3_close(sqlite_db_);
+  // results may still hold their statement,
+  // the handle is released once they are finalized
+  int ret = sqlite3_close_v2(sqlite_db_);
   
   throw_error(ret, sqlite_db_, "sqlite_close");
 
@@ -81,17 +103,17 @@ sqlite3* sqlite_connection::handle()
 
 void sqlite_connection::begin()
 {
-  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("BEGIN TRANSACTION;")));
+  std::unique_ptr<detail::result_impl> res(execute("BEGIN TRANSACTION;"));
 }
 
 void sqlite_connection::commit()
 {
-  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("COMMIT TRANSACTION;")));
+  std::unique_ptr<detail::result_impl> res(execute("COMMIT TRANSACTION;"));
 }
 
 void sqlite_connection::rollback()
 {
-  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("ROLLBACK TRANSACTION;")));
+  std::unique_ptr<detail::result_impl> res(execute("ROLLBACK TRANSACTION;"));
 }
 
 std::string sqlite_connection::type() const
@@ -113,15 +135,49 @@ oos::detail::result_impl* sqlite_connection::execute(const oos::sql &sql)
 
 oos::detail::result_impl* sqlite_connection::execute(const std::string &stmt)
 {
-  std::unique_ptr<sqlite_result> res(new sqlite_result);
-  char *errmsg = 0;
-  int ret = sqlite3_exec(sqlite_db_, stmt.c_str(), parse_result, res.get(), &errmsg);
-  if (ret != SQLITE_OK) {
-    std::string error(errmsg);
-    sqlite3_free(errmsg);
+  const char *sql = stmt.c_str();
+  sqlite3_stmt *current = nullptr;
+  while (sql != nullptr && *sql != '\0') {
+    sqlite3_stmt *next = nullptr;
+    const char *tail = nullptr;
+    int ret = sqlite3_prepare_v2(sqlite_db_, sql, -1, &next, &tail);
+    if (ret != SQLITE_OK) {
+      sqlite3_finalize(current);
+      throw_error(ret, sqlite_db_, "sqlite3_prepare_v2");
+    }
+    sql = tail;
+    if (next == nullptr) {
+      // only whitespace or a comment
+      continue;
+    }
+    if (current != nullptr) {
+      // all but the last statement are executed
+      // completely, the rows of the last one are
+      // streamed by the result
+      step(current, true);
+      sqlite3_finalize(current);
+    }
+    current = next;
+  }
+  if (current == nullptr) {
+    return new sqlite_prepared_result(nullptr, SQLITE_DONE);
+  }
+  int ret = step(current, false);
+  return new sqlite_prepared_result(current, ret, true);
+}
+
+int sqlite_connection::step(sqlite3_stmt *stmt, bool to_completion)
+{
+  int ret;
+  do {
+    ret = sqlite3_step(stmt);
+  } while (to_completion && ret == SQLITE_ROW);
+  if (ret != SQLITE_ROW && ret != SQLITE_DONE) {
+    std::string error(sqlite3_errmsg(sqlite_db_));
+    sqlite3_finalize(stmt);
     throw sqlite_exception(error);
   }
-  return res.release();
+  return ret;
 }
 
 oos::detail::statement_impl *sqlite_connection::prepare(const oos::sql &sql)
@@ -133,9 +189,9 @@ oos::detail::statement_impl *sqlite_connection::prepare(const oos::sql &sql)
 bool sqlite_connection::exists(const std::string &tablename)
 {
   std::string stmt("SELECT COUNT(*) FROM sqlite_master WHERE type='table' AND tbl_name='" + tablename + "' LIMIT 1");
-  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute(stmt)));
+  std::unique_ptr<detail::result_impl> res(execute(stmt));
 
-  if (res->result_rows() != 1) {
+  if (!res->fetch()) {
     return false;
   } else {
     char *end;
@@ -146,11 +202,11 @@ bool sqlite_connection::exists(const std::string &tablename)
 std::vector<field> sqlite_connection::describe(const std::string &table)
 {
   std::string stmt("PRAGMA table_info(" + table + ")");
-  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute(stmt)));
+  std::unique_ptr<detail::result_impl> res(execute(stmt));
 
   std::vector<field> fields;
 
-  do {
+  while (res->fetch()) {
     field f;
     char *end = nullptr;
     f.index(strtoul(res->column(0), &end, 10));
@@ -162,7 +218,7 @@ std::vector<field> sqlite_connection::describe(const std::string &table)
 //    end = nullptr;
 //    f.is_primary_key(strtoul(res->column(3), &end, 10) == 0);
     fields.push_back(f);
-  } while (res->fetch());
+  }
 
   return fields;
 }
@@ -172,24 +228,6 @@ basic_dialect *sqlite_connection::dialect()
   return &dialect_;
 }
 
-int sqlite_connection::parse_result(void* param, int column_count, char** values, char** /*columns*/)
-{
-  sqlite_result *result = static_cast<sqlite_result*>(param);
-
-  /********************
-   *
-   * a new row was retrieved
-   * add a new row to the result
-   * and iterator over all columns
-   * adding each column value as
-   * string to the row
-   *
-   ********************/
-
-  result->push_back(values, column_count);
-  return 0;
-}
-
 unsigned long sqlite_connection::last_inserted_id()
 {
   return static_cast<unsigned long>(sqlite3_last_insert_rowid(sqlite_db_));
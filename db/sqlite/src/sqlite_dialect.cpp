@@ -3,8 +3,7 @@
 //
 #include "sqlite_dialect.hpp"
 #include "sqlite_dialect_compiler.hpp"
-
-#include "sql/basic_dialect_linker.hpp"
+#include "sqlite_dialect_linker.hpp"
 
 #include <algorithm>
 
@@ -14,7 +13,7 @@ namespace sqlite {
 
 
 sqlite_dialect::sqlite_dialect()
-  : basic_dialect(new sqlite_dialect_compiler(*this), new detail::basic_dialect_linker)
+  : basic_dialect(new sqlite_dialect_compiler(*this), new sqlite_dialect_linker)
 {
   replace_token(detail::token::BEGIN, "BEGIN TRANSACTION");
   replace_token(detail::token::COMMIT, "COMMIT TRANSACTION");
@@ -53,9 +52,9 @@ const char *sqlite_dialect::type_string(oos::data_type type) const
     case data_type::type_text:
       return "TEXT";
     case data_type::type_date:
-      return "TEXT";
+      return integer_date_time_ ? "DATE" : "TEXT";
     case data_type::type_time:
-      return "TEXT";
+      return integer_date_time_ ? "TIMESTAMP" : "TEXT";
     default: {
       std::stringstream msg;
       msg << "sqlite sql: unknown type [" << (int)type << "]";
@@ -73,6 +72,10 @@ data_type sqlite_dialect::string_type(const char *type) const
     return data_type::type_text;
   } else if (strcmp(type, "REAL") == 0) {
     return data_type::type_double;
+  } else if (strcmp(type, "DATE") == 0) {
+    return data_type::type_date;
+  } else if (strcmp(type, "TIMESTAMP") == 0) {
+    return data_type::type_time;
   } else if (strcmp(type, "BLOB") == 0) {
     return data_type::type_blob;
   } else if (strcmp(type, "NULL") == 0) {
@@ -84,6 +87,16 @@ data_type sqlite_dialect::string_type(const char *type) const
   }
 }
 
+void sqlite_dialect::integer_date_time(bool enable)
+{
+  integer_date_time_ = enable;
+}
+
+bool sqlite_dialect::integer_date_time() const
+{
+  return integer_date_time_;
+}
+
 }
 
 }
\ No newline at end of file
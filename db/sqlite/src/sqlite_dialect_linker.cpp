@@ -0,0 +1,35 @@
+#include "sqlite_dialect_linker.hpp"
+#include "sqlite_dialect.hpp"
+#include "sqlite_types.hpp"
+
+#include "sql/basic_dialect.hpp"
+#include "sql/value.hpp"
+
+#include <string>
+
+namespace oos {
+
+namespace sqlite {
+
+void sqlite_dialect_linker::visit(const oos::detail::basic_value &val)
+{
+  if (!is_direct(dialect()) || !static_cast<sqlite_dialect&>(dialect()).integer_date_time()) {
+    basic_dialect_linker::visit(val);
+    return;
+  }
+  const value<oos::date> *date_value = dynamic_cast<const value<oos::date>*>(&val);
+  if (date_value != nullptr) {
+    append_to_result(dialect(), std::to_string(date_value->val.julian_date()));
+    return;
+  }
+  const value<oos::time> *time_value = dynamic_cast<const value<oos::time>*>(&val);
+  if (time_value != nullptr) {
+    append_to_result(dialect(), std::to_string(to_microseconds(time_value->val)));
+    return;
+  }
+  basic_dialect_linker::visit(val);
+}
+
+}
+
+}
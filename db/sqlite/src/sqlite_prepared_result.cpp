@@ -1,11 +1,15 @@
 #include "sqlite_prepared_result.hpp"
+#include "sqlite_types.hpp"
 
 #include "tools/date.hpp"
 #include "tools/time.hpp"
 #include "tools/varchar.hpp"
 #include "tools/basic_identifier.hpp"
+#include "tools/string.hpp"
 
+#include <cctype>
 #include <cstring>
+#include <string>
 
 #include <sqlite3.h>
 
@@ -13,38 +17,63 @@ namespace oos {
 
 namespace sqlite {
 
-sqlite_prepared_result::sqlite_prepared_result(sqlite3_stmt *stmt, int ret)
+namespace {
+
+// checks for a leading ISO 8601 date (YYYY-MM-DD)
+bool starts_with_iso_date(const std::string &val)
+{
+  if (val.size() < 10 || val[4] != '-' || val[7] != '-') {
+    return false;
+  }
+  for (std::string::size_type i = 0; i < 10; ++i) {
+    if (i != 4 && i != 7 && !std::isdigit(static_cast<unsigned char>(val[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+sqlite_prepared_result::sqlite_prepared_result(sqlite3_stmt *stmt, int ret, bool owns_stmt)
   : ret_(ret)
-  , first_(true)
+  , stepped_(true)
+  , owns_stmt_(owns_stmt)
   , rows(0)
   , fields_(0)
   , stmt_(stmt)
 {
+  if (stmt_) {
+    fields_ = (size_type)sqlite3_column_count(stmt_);
+  }
+  if (ret_ != SQLITE_ROW) {
+    release();
+  }
 }
 
 sqlite_prepared_result::~sqlite_prepared_result()
 {
+  if (owns_stmt_) {
+    sqlite3_finalize(stmt_);
+  }
 }
 
-const char* sqlite_prepared_result::column(size_type ) const
+const char* sqlite_prepared_result::column(size_type c) const
 {
-  return 0;
+  const char *text = (const char*)sqlite3_column_text(stmt_, (int)c);
+  return text != nullptr ? text : "";
 }
 
 bool sqlite_prepared_result::fetch()
 {
-  if (!first_) {
-    // get next row
-    ret_ = sqlite3_step(stmt_);
-  } else {
-    first_ = false;
-  }
-  return !(ret_ == SQLITE_DONE || ret_ == SQLITE_OK);
-
+  return next_row();
 }
 
 sqlite_prepared_result::size_type sqlite_prepared_result::affected_rows() const
 {
+  if (!stmt_) {
+    return 0;
+  }
   sqlite3 *db = sqlite3_db_handle(stmt_);
   return (size_type)sqlite3_changes(db);
 }
@@ -66,7 +95,13 @@ int sqlite_prepared_result::transform_index(int index) const
 
 void sqlite_prepared_result::serialize(const char *, char &x)
 {
-  x = (char)sqlite3_column_int(stmt_, result_index_++);
+  if (sqlite3_column_type(stmt_, result_index_) == SQLITE_TEXT) {
+    // a character written as a literal
+    const char *text = (const char*)sqlite3_column_text(stmt_, result_index_++);
+    x = text[0];
+  } else {
+    x = (char)sqlite3_column_int(stmt_, result_index_++);
+  }
 }
 
 void sqlite_prepared_result::serialize(const char *, short &x)
@@ -81,7 +116,7 @@ void sqlite_prepared_result::serialize(const char *, int &x)
 
 void sqlite_prepared_result::serialize(const char *, long &x)
 {
-  x = (long)sqlite3_column_int(stmt_, result_index_++);
+  x = (long)sqlite3_column_int64(stmt_, result_index_++);
 }
 
 void sqlite_prepared_result::serialize(const char *, unsigned char &x)
@@ -101,7 +136,7 @@ void sqlite_prepared_result::serialize(const char *, unsigned int &x)
 
 void sqlite_prepared_result::serialize(const char *, unsigned long &x)
 {
-  x = (unsigned long)sqlite3_column_int(stmt_, result_index_++);
+  x = (unsigned long)sqlite3_column_int64(stmt_, result_index_++);
 }
 
 void sqlite_prepared_result::serialize(const char *, bool &x)
@@ -158,16 +193,48 @@ void sqlite_prepared_result::serialize(const char *, char *x, size_t s)
 
 void sqlite_prepared_result::serialize(const char *id, oos::date &x)
 {
-  double val = 0;
-  serialize(id, val);
-  x.set(static_cast<int>(val));
+  int type = sqlite3_column_type(stmt_, result_index_);
+  if (type == SQLITE_INTEGER) {
+    x.set(sqlite3_column_int(stmt_, result_index_++));
+  } else if (type == SQLITE_NULL) {
+    ++result_index_;
+  } else if (type == SQLITE_TEXT) {
+    // dates written as text by former versions or
+    // julian days converted to text by a TEXT column
+    std::string val;
+    serialize(id, val);
+    if (starts_with_iso_date(val)) {
+      x.set(val.c_str(), date_format::ISO8601);
+    } else {
+      x.set((int)std::stol(val));
+    }
+  } else {
+    x.set(static_cast<int>(sqlite3_column_double(stmt_, result_index_++)));
+  }
 }
 
 void sqlite_prepared_result::serialize(const char *id, oos::time &x)
 {
+  int type = sqlite3_column_type(stmt_, result_index_);
+  if (type == SQLITE_INTEGER) {
+    x = from_microseconds(sqlite3_column_int64(stmt_, result_index_++));
+    return;
+  } else if (type == SQLITE_NULL) {
+    ++result_index_;
+    return;
+  }
+  // times written as text by former versions or
+  // microseconds converted to text by a TEXT column
   std::string val;
   serialize(id, val);
-  x = oos::time::parse(val, "%F %T.%f");
+  if (!starts_with_iso_date(val)) {
+    x = from_microseconds(std::stoll(val));
+  } else if (val.size() > 10 && val[10] == 'T') {
+    // direct statements wrote the time with a 'T' separator
+    x = oos::time::parse(val, "%FT%T.%f");
+  } else {
+    x = oos::time::parse(val, "%F %T.%f");
+  }
 }
 
 void sqlite_prepared_result::serialize(const char *id, identifiable_holder &x, cascade_type)
@@ -182,20 +249,55 @@ void sqlite_prepared_result::serialize(const char *id, basic_identifier &x)
 
 bool sqlite_prepared_result::prepare_fetch()
 {
-  if (!first_) {
-    // get next row
-    ret_ = sqlite3_step(stmt_);
-  } else {
-    first_ = false;
-  }
-  return !(ret_ == SQLITE_DONE || ret_ == SQLITE_OK);
+  return next_row();
 }
 
 bool sqlite_prepared_result::finalize_fetch()
 {
+  // the row is read into the object, so the
+  // next one is stepped already to find out
+  // if this was the last one
+  step();
+  return true;
+}
+
+bool sqlite_prepared_result::next_row()
+{
+  if (!stepped_) {
+    step();
+  }
+  // the row is consumed now
+  stepped_ = false;
+  if (ret_ != SQLITE_ROW) {
+    return false;
+  }
+  ++rows;
   return true;
 }
 
+void sqlite_prepared_result::step()
+{
+  if (stepped_ || ret_ != SQLITE_ROW) {
+    // a statement which is done isn't stepped
+    // again because sqlite would rerun it
+    return;
+  }
+  ret_ = sqlite3_step(stmt_);
+  stepped_ = true;
+  if (ret_ != SQLITE_ROW) {
+    release();
+  }
+}
+
+void sqlite_prepared_result::release()
+{
+  // all rows are read, resetting the
+  // statement releases its read lock
+  if (stmt_) {
+    sqlite3_reset(stmt_);
+  }
+}
+
 }
 
 }
@@ -17,8 +17,10 @@
 
 #include "sqlite_statement.hpp"
 #include "sqlite_connection.hpp"
+#include "sqlite_dialect.hpp"
 #include "sqlite_exception.hpp"
 #include "sqlite_prepared_result.hpp"
+#include "sqlite_types.hpp"
 
 #include "sql/row.hpp"
 
@@ -175,27 +177,46 @@ void sqlite_statement::serialize(const char*, varchar_base &x)
   throw_error(ret, db_.handle(), "sqlite3_bind_text");
 }
 
-void sqlite_statement::serialize(const char *id, oos::date &x)
+void sqlite_statement::serialize(const char*, oos::date &x)
 {
-  auto date_string = std::make_shared<std::string>(oos::to_string(x, date_format::ISO8601));
-  serialize(id, *date_string);
-  host_strings_.push_back(date_string);
-//  int ret = sqlite3_bind_int(stmt_, (int)++host_index, x.julian_date());
-//  throw_error(ret, db_.handle(), "sqlite3_bind_int");
+  if (integer_date_time()) {
+    // dates are stored as julian day
+    int ret = sqlite3_bind_int(stmt_, (int)++host_index, x.julian_date());
+    throw_error(ret, db_.handle(), "sqlite3_bind_int");
+  } else {
+    // sqlite copies the formatted date
+    std::string date_string(oos::to_string(x, date_format::ISO8601));
+    int ret = sqlite3_bind_text(stmt_, (int)++host_index, date_string.c_str(), (int)date_string.size(), SQLITE_TRANSIENT);
+    throw_error(ret, db_.handle(), "sqlite3_bind_text");
+  }
+}
+
+void sqlite_statement::serialize(const char*, oos::time &x)
+{
+  if (integer_date_time()) {
+    // times are stored as microseconds since epoch
+    int ret = sqlite3_bind_int64(stmt_, (int)++host_index, to_microseconds(x));
+    throw_error(ret, db_.handle(), "sqlite3_bind_int64");
+  } else {
+    // sqlite copies the formatted time
+    std::string time_string(oos::to_string(x, "%F %T.%f"));
+    int ret = sqlite3_bind_text(stmt_, (int)++host_index, time_string.c_str(), (int)time_string.size(), SQLITE_TRANSIENT);
+    throw_error(ret, db_.handle(), "sqlite3_bind_text");
+  }
 }
 
-void sqlite_statement::serialize(const char *id, oos::time &x)
+bool sqlite_statement::integer_date_time() const
 {
-  // format time to ISO8601
-  auto time_string = std::make_shared<std::string>(oos::to_string(x, "%F %T.%f"));
-  serialize(id, *time_string);
-  host_strings_.push_back(time_string);
+  return static_cast<sqlite_dialect*>(db_.dialect())->integer_date_time();
 }
 
 void sqlite_statement::serialize(const char *id, identifiable_holder &x, cascade_type)
 {
   if (x.has_primary_key()) {
     x.primary_key()->serialize(id, *this);
+  } else {
+    int ret = sqlite3_bind_null(stmt_, (int)++host_index);
+    throw_error(ret, db_.handle(), "sqlite3_bind_null");
   }
 }
 
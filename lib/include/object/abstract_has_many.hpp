@@ -36,6 +36,28 @@ public:
   std::string owner_field() const { return owner_field_; }
   std::string item_field() const { return item_field_; }
 
+  /**
+   * Sets the loader which loads the elements
+   * of the container on first access.
+   *
+   * @param loader The element loader
+   */
+  void loader(const std::function<void()> &loader) { loader_ = loader; }
+
+protected:
+  /**
+   * Calls the element loader once if set.
+   */
+  void load() const
+  {
+    if (!loader_) {
+      return;
+    }
+    std::function<void()> loader;
+    loader.swap(loader_);
+    loader();
+  }
+
 protected:
   friend class detail::object_inserter;
 
@@ -43,6 +65,8 @@ protected:
 
   std::string owner_field_ = "owner_id";
   std::string item_field_ = "item_id";
+
+  mutable std::function<void()> loader_;
 };
 
 /// @endcond
@@ -34,6 +34,7 @@
 #include <string>
 #include <list>
 #include <memory>
+#include <cstddef>
 
 namespace oos {
 
@@ -90,14 +91,32 @@ public:
    */
   virtual void restore(byte_buffer &from, object_store *store) = 0;
 
+  /**
+   * @brief Sets the position of the backup in the byte_buffer
+   *
+   * @param pos The position of the backup
+   */
+  void backup_position(std::size_t pos);
+
+  /**
+   * @brief Returns the position of the backup in the byte_buffer
+   *
+   * @return The position of the backup
+   */
+  std::size_t backup_position() const;
+
 protected:
   /// @cond OOS_DEV
   static void remove_proxy(object_proxy *proxy, object_store *store);
   static object_proxy* find_proxy(object_store *store, unsigned long id);
   static void insert_proxy(object_store *store, object_proxy *proxy);
+  static void move_backup(action &from, action &to);
 
 protected:
   object_serializer *serializer_;
+
+private:
+  std::size_t backup_position_ = 0;
   /// @endcond
 };
 
@@ -23,12 +23,14 @@
 #include "object/insert_action.hpp"
 
 #include <vector>
+#include <unordered_map>
 
 namespace oos {
 
 /// @cond OOS_DEV
 
 class object_proxy;
+class prototype_node;
 
 class OOS_API action_inserter : public action_visitor
 {
@@ -52,9 +54,13 @@ public:
 private:
   void* object(object_proxy *proxy) const;
   const char* type(object_proxy *proxy) const;
+  const prototype_node* node(object_proxy *proxy) const;
 
 private:
+  typedef std::unordered_map<const prototype_node*, t_action_vactor::size_type> t_insert_action_index_map;
+
   std::reference_wrapper<t_action_vactor> actions_;
+  t_insert_action_index_map insert_action_index_map_;
   object_proxy *proxy_ = nullptr;
   bool inserted_ = false;
 };
@@ -63,25 +69,22 @@ template < class T >
 action_inserter::t_action_vactor::size_type action_inserter::insert(object_proxy *proxy) {
   proxy_ = proxy;
   inserted_ = false;
-  t_action_vactor::size_type end = actions_.get().size();
-  for (t_action_vactor::size_type i = 0; i < end; ++i) {
-//  while (first != last) {
-    actions_.get().at(i)->accept(this);
-
-//    (*first)->accept(this);
+  // look up the insert action of the objects type
+  // instead of visiting all actions
+  t_insert_action_index_map::iterator i = insert_action_index_map_.find(node(proxy));
+  if (i != insert_action_index_map_.end() && i->second < actions_.get().size()) {
+    actions_.get().at(i->second)->accept(this);
     if (inserted_) {
-      return i;
+      return i->second;
     }
   }
-  if (!inserted_) {
-    T* obj = (T*)object(proxy);
-    const char* t = type(proxy);
-    std::shared_ptr<insert_action> ia(new insert_action(t, obj));
-    ia->push_back(proxy_);
-    actions_.get().push_back(ia);
-    return actions_.get().size() - 1;
-  }
-  return actions_.get().size();
+  T* obj = (T*)object(proxy);
+  const char* t = type(proxy);
+  std::shared_ptr<insert_action> ia(std::make_shared<insert_action>(t, obj));
+  ia->push_back(proxy_);
+  actions_.get().push_back(ia);
+  insert_action_index_map_[node(proxy)] = actions_.get().size() - 1;
+  return actions_.get().size() - 1;
 }
 
 /// @endcond
@@ -69,26 +69,26 @@ public:
    *
    * @return The begin iterator
    */
-  iterator begin() { return iterator(container_.begin()); }
+  iterator begin() { load(); return iterator(container_.begin()); }
   /**
    * @brief Returns the end iterator of the container
    *
    * @return The end iterator
    */
-  iterator end() { return iterator(container_.end()); }
+  iterator end() { load(); return iterator(container_.end()); }
 
   /**
    * @brief Returns the const begin iterator of the container
    *
    * @return The const begin iterator
    */
-  const_iterator begin() const { return const_iterator(container_.begin()); }
+  const_iterator begin() const { load(); return const_iterator(container_.begin()); }
   /**
    * @brief Returns the const end iterator of the container
    *
    * @return The const end iterator
    */
-  const_iterator end() const { return const_iterator(container_.end()); }
+  const_iterator end() const { load(); return const_iterator(container_.end()); }
 
   /**
    * @brief Returns a copy of the first element
@@ -133,14 +133,14 @@ public:
    *
    * @return The current size
    */
-  size_type size() const { return container_.size(); }
+  size_type size() const { load(); return container_.size(); }
 
   /**
    * @brief Returns true if the container is empty
    *
    * @return True if the container is empty
    */
-  bool empty() const { return container_.empty(); }
+  bool empty() const { load(); return container_.empty(); }
 
   /**
    * @brief Clears the container
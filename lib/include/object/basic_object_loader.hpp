@@ -0,0 +1,51 @@
+#ifndef OOS_BASIC_OBJECT_LOADER_HPP
+#define OOS_BASIC_OBJECT_LOADER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+namespace oos {
+
+class object_proxy;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Interface for loading objects on demand
+ *
+ * An object proxy holding a primary key but no object
+ * can be given a loader. On first access of the object
+ * the loader is called to load the object into the proxy.
+ */
+class OOS_API basic_object_loader
+{
+public:
+  virtual ~basic_object_loader() {}
+
+  /**
+   * Loads the object represented by the
+   * primary key of the given proxy.
+   *
+   * @param proxy The proxy to load the object for
+   */
+  virtual void load_object(object_proxy *proxy) = 0;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_BASIC_OBJECT_LOADER_HPP
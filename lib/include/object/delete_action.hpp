@@ -132,6 +132,7 @@ private:
       // data from buffer into serializable
       T *obj = act->init_object((T*)proxy->obj());
       serializer.deserialize(obj, &buffer, store);
+      proxy->mark_indexes_dirty();
     }
   }
 
@@ -0,0 +1,170 @@
+#ifndef OOS_FIELD_SNAPSHOT_HPP
+#define OOS_FIELD_SNAPSHOT_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+#define OOS_API __declspec(dllexport)
+#define EXPIMP_TEMPLATE
+#else
+#define OOS_API __declspec(dllimport)
+#define EXPIMP_TEMPLATE extern
+#endif
+#pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "tools/access.hpp"
+#include "tools/serializer.hpp"
+#include "tools/basic_identifier.hpp"
+#include "tools/identifiable_holder.hpp"
+#include "tools/varchar.hpp"
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Takes a snapshot of all fields of an object
+ *
+ * The snapshot holds the binary image of each field
+ * (in serialization order) of an object. The images
+ * can be compared with the current state of the object
+ * to find out which fields were modified. Has many
+ * relations aren't part of the snapshot because they
+ * aren't stored in the objects table.
+ */
+class OOS_API field_snapshot : public serializer
+{
+public:
+  typedef std::vector<bool> t_field_mask; /**< Shortcut to the modified field mask */
+
+  field_snapshot();
+  virtual ~field_snapshot();
+
+  /**
+   * Takes the snapshot of the given object.
+   *
+   * @tparam T The type of the object
+   * @param obj The object to take the snapshot from
+   */
+  template < class T >
+  void take(T &obj)
+  {
+    image_.clear();
+    ends_.clear();
+    current_.clear();
+    compare_ = false;
+    index_ = 0;
+    oos::access::serialize(*this, obj);
+  }
+
+  /**
+   * Compares the snapshot with the given object
+   * and returns a mask where each modified field
+   * is marked with true.
+   *
+   * @tparam T The type of the object
+   * @param obj The object to compare with
+   * @return The mask of the modified fields
+   */
+  template < class T >
+  t_field_mask modified(T &obj)
+  {
+    modified_.clear();
+    modified_.reserve(ends_.size());
+    current_.clear();
+    compare_ = true;
+    index_ = 0;
+    oos::access::serialize(*this, obj);
+    t_field_mask mask;
+    mask.swap(modified_);
+    return mask;
+  }
+
+  template < class V >
+  void serialize(V &x)
+  {
+    oos::access::serialize(*this, x);
+  }
+
+  void serialize(const char *id, char &x) override;
+  void serialize(const char *id, short &x) override;
+  void serialize(const char *id, int &x) override;
+  void serialize(const char *id, long &x) override;
+  void serialize(const char *id, unsigned char &x) override;
+  void serialize(const char *id, unsigned short &x) override;
+  void serialize(const char *id, unsigned int &x) override;
+  void serialize(const char *id, unsigned long &x) override;
+  void serialize(const char *id, bool &x) override;
+  void serialize(const char *id, float &x) override;
+  void serialize(const char *id, double &x) override;
+  void serialize(const char *id, char *x, size_t s) override;
+  void serialize(const char *id, std::string &x) override;
+  void serialize(const char *id, varchar_base &x) override;
+  void serialize(const char *id, time &x) override;
+  void serialize(const char *id, date &x) override;
+  void serialize(const char *id, basic_identifier &x) override;
+  void serialize(const char *id, identifiable_holder &x, cascade_type) override;
+
+  template < unsigned int S >
+  void serialize(const char *id, varchar<S> &x)
+  {
+    serialize(id, static_cast<varchar_base&>(x));
+  }
+
+  /*
+   * identifiers and has one fields
+   * serialized without cascade type
+   */
+  template < class V >
+  void serialize(const char *id, V &x)
+  {
+    serialize(id, x, std::is_base_of<identifiable_holder, V>());
+  }
+
+  template < class HAS_MANY >
+  void serialize(const char *, HAS_MANY &, const char *, const char *) {}
+
+private:
+  template < class V >
+  void serialize(const char *id, V &x, std::true_type)
+  {
+    serialize(id, static_cast<identifiable_holder&>(x), cascade_type::NONE);
+  }
+
+  template < class V >
+  void serialize(const char *id, V &x, std::false_type)
+  {
+    serialize(id, static_cast<basic_identifier&>(x));
+  }
+
+  void append(const void *data, size_t size);
+  void next_field();
+
+private:
+  // the images of all fields one after another
+  // and the end of each field in the images
+  std::vector<char> image_;
+  std::vector<std::size_t> ends_;
+  t_field_mask modified_;
+  // the image of the current field
+  std::vector<char> current_;
+  size_t index_ = 0;
+  unsigned depth_ = 0;
+  bool compare_ = false;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_FIELD_SNAPSHOT_HPP
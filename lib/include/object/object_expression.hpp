@@ -31,6 +31,7 @@
 #endif
 
 #include "object/object_ptr.hpp"
+#include "object/object_proxy_accessor.hpp"
 
 #include <string>
 
@@ -51,6 +52,11 @@ public:
     return constant_;
   }
 
+  const T& value() const
+  {
+    return constant_;
+  }
+
 private:
   T constant_;
 };
@@ -60,10 +66,24 @@ class variable_impl
 {
 public:
   typedef R return_type;
+  typedef return_type (*reader_type)(const variable_impl<R> &var, const void *obj);
 
   virtual ~variable_impl() {}
   
   virtual return_type operator()(const object_holder &optr) const = 0;
+
+  /**
+   * Returns a function reading the value directly
+   * from the object. If the value can only be read
+   * through the object_holder (i.e. it belongs to
+   * a related object) nullptr is returned.
+   *
+   * @return The reader function or nullptr
+   */
+  virtual reader_type reader() const
+  {
+    return nullptr;
+  }
 };
 
 template < class R, class O, class V >
@@ -111,6 +131,22 @@ public:
     return (static_cast<const object_type*>(optr.ptr())->*m_)();
   }
 
+  memfunc_type member() const
+  {
+    return m_;
+  }
+
+  virtual typename variable_impl<R>::reader_type reader() const
+  {
+    return &object_variable_impl::read;
+  }
+
+private:
+  static return_type read(const variable_impl<R> &var, const void *obj)
+  {
+    return (static_cast<const object_type*>(obj)->*static_cast<const object_variable_impl&>(var).m_)();
+  }
+
 private:
   memfunc_type m_;
 };
@@ -175,6 +211,17 @@ public:
   {
     return impl_->operator()(optr);
   }
+
+  /**
+   * Returns the concrete variable
+   * implementation.
+   *
+   * @return The concrete variable.
+   */
+  const variable_impl<R>& impl() const
+  {
+    return *impl_;
+  }
   
 private:
   std::shared_ptr<variable_impl<R> > impl_;
@@ -342,6 +389,11 @@ public:
     return op_(left_(optr));
   }
 
+  const typename expression_traits<L>::expression_type& left() const
+  {
+    return left_;
+  }
+
 private:
   typename expression_traits<L>::expression_type left_;
   OP op_;
@@ -362,6 +414,16 @@ public:
     return op_(left_(optr), right_(optr));
   }
 
+  const typename expression_traits<L>::expression_type& left() const
+  {
+    return left_;
+  }
+
+  const typename expression_traits<R>::expression_type& right() const
+  {
+    return right_;
+  }
+
 private:
   typename expression_traits<L>::expression_type left_;
   typename expression_traits<R>::expression_type right_;
@@ -611,8 +673,276 @@ unary_expression<binary_expression<L, R, OP>, std::logical_not<bool> > operator!
   return unary_expression<binary_expression<L, R, OP>, std::logical_not<bool> >(l);
 }
 
+/*
+ * The compiled expression types mirror an expression
+ * tree for a concrete object type T. Each node is a
+ * plain class without virtual methods evaluating the
+ * raw object. Constants are stored once and returned
+ * by reference, variables read the member function
+ * directly and logical operators short-circuit.
+ */
+template < class T, class E >
+struct compiled_traits;
+
+template < class T, class E >
+class compiled_fallback
+{
+public:
+  explicit compiled_fallback(const E &expr)
+    : expr_(expr)
+  {}
+
+  bool operator()(const T *, object_proxy *proxy) const
+  {
+    return expr_(object_ptr<T>(proxy));
+  }
+
+private:
+  E expr_;
+};
+
+template < class T, class V >
+class compiled_constant
+{
+public:
+  explicit compiled_constant(const constant<V> &c)
+    : value_(c.value())
+  {}
+
+  const V& operator()(const T *, object_proxy *) const
+  {
+    return value_;
+  }
+
+private:
+  V value_;
+};
+
+template < class T, class R >
+class compiled_variable
+{
+public:
+  typedef R (T::*memfunc_type)() const;
+  typedef typename variable_impl<R>::reader_type reader_type;
+
+  explicit compiled_variable(const variable<R> &var)
+    : var_(var)
+  {
+    // a member of T itself is called directly,
+    // a member of a base type through its reader
+    typedef object_variable_impl<R, T, null_var> direct_type;
+    const direct_type *direct = dynamic_cast<const direct_type*>(&var.impl());
+    if (direct != nullptr) {
+      m_ = direct->member();
+    } else {
+      reader_ = var.impl().reader();
+    }
+  }
+
+  R operator()(const T *obj, object_proxy *proxy) const
+  {
+    if (m_ != nullptr) {
+      return (obj->*m_)();
+    } else if (reader_ != nullptr) {
+      return reader_(var_.impl(), obj);
+    } else {
+      // the value belongs to a related object
+      return var_(object_ptr<T>(proxy));
+    }
+  }
+
+private:
+  variable<R> var_;
+  memfunc_type m_ = nullptr;
+  reader_type reader_ = nullptr;
+};
+
+template < class T, class L, class R, class OP >
+class compiled_binary
+{
+public:
+  explicit compiled_binary(const binary_expression<L, R, OP> &expr)
+    : left_(expr.left())
+    , right_(expr.right())
+  {}
+
+  bool operator()(const T *obj, object_proxy *proxy) const
+  {
+    return op_(left_(obj, proxy), right_(obj, proxy));
+  }
+
+private:
+  typename compiled_traits<T, typename expression_traits<L>::expression_type>::type left_;
+  typename compiled_traits<T, typename expression_traits<R>::expression_type>::type right_;
+  OP op_;
+};
+
+template < class T, class L, class R >
+class compiled_binary<T, L, R, std::logical_and<bool> >
+{
+public:
+  explicit compiled_binary(const binary_expression<L, R, std::logical_and<bool> > &expr)
+    : left_(expr.left())
+    , right_(expr.right())
+  {}
+
+  bool operator()(const T *obj, object_proxy *proxy) const
+  {
+    return left_(obj, proxy) && right_(obj, proxy);
+  }
+
+private:
+  typename compiled_traits<T, typename expression_traits<L>::expression_type>::type left_;
+  typename compiled_traits<T, typename expression_traits<R>::expression_type>::type right_;
+};
+
+template < class T, class L, class R >
+class compiled_binary<T, L, R, std::logical_or<bool> >
+{
+public:
+  explicit compiled_binary(const binary_expression<L, R, std::logical_or<bool> > &expr)
+    : left_(expr.left())
+    , right_(expr.right())
+  {}
+
+  bool operator()(const T *obj, object_proxy *proxy) const
+  {
+    return left_(obj, proxy) || right_(obj, proxy);
+  }
+
+private:
+  typename compiled_traits<T, typename expression_traits<L>::expression_type>::type left_;
+  typename compiled_traits<T, typename expression_traits<R>::expression_type>::type right_;
+};
+
+template < class T, class L, class OP >
+class compiled_unary
+{
+public:
+  explicit compiled_unary(const unary_expression<L, OP> &expr)
+    : left_(expr.left())
+  {}
+
+  bool operator()(const T *obj, object_proxy *proxy) const
+  {
+    return op_(left_(obj, proxy));
+  }
+
+private:
+  typename compiled_traits<T, typename expression_traits<L>::expression_type>::type left_;
+  OP op_;
+};
+
+template < class T, class E >
+struct compiled_traits
+{
+  typedef compiled_fallback<T, E> type;
+};
+
+template < class T, class V >
+struct compiled_traits<T, constant<V> >
+{
+  typedef compiled_constant<T, V> type;
+};
+
+template < class T, class R >
+struct compiled_traits<T, variable<R> >
+{
+  typedef compiled_variable<T, R> type;
+};
+
+template < class T, class L, class R, class OP >
+struct compiled_traits<T, binary_expression<L, R, OP> >
+{
+  typedef compiled_binary<T, L, R, OP> type;
+};
+
+template < class T, class L, class OP >
+struct compiled_traits<T, unary_expression<L, OP> >
+{
+  typedef compiled_unary<T, L, OP> type;
+};
+
 /// @endcond
 
+/**
+ * @brief An expression compiled for objects of type T
+ *
+ * The compiled expression evaluates the objects of type T
+ * without any virtual call or object_holder. Constants
+ * are evaluated once, members are read directly from the
+ * object and logical and/or short-circuit. It is meant
+ * to be created once and applied to many objects.
+ *
+ * @code
+ * auto compiled = oos::compile<item>(make_var(&item::id) > 6 && make_var(&item::name) == std::string("x"));
+ * bool match = compiled(optr);
+ * @endcode
+ *
+ * @tparam T The type of the objects
+ * @tparam E The type of the expression
+ */
+template < class T, class E >
+class compiled_expression
+{
+public:
+  /**
+   * Compiles the given expression
+   *
+   * @param expr The expression to compile
+   */
+  explicit compiled_expression(const E &expr)
+    : evaluator_(expr)
+  {}
+
+  /**
+   * Evaluates the object of the given proxy.
+   * An object which isn't loaded yet is loaded
+   * first. A proxy without an object doesn't match.
+   *
+   * @param proxy The proxy of the object
+   * @return True if the object matches the expression
+   */
+  bool operator()(object_proxy *proxy) const
+  {
+    if (proxy->obj() == nullptr) {
+      proxy->load();
+    }
+    const T *obj = static_cast<const T*>(proxy->obj());
+    return obj != nullptr && evaluator_(obj, proxy);
+  }
+
+  /**
+   * Evaluates the object of the given holder.
+   *
+   * @param optr The holder of the object
+   * @return True if the object matches the expression
+   */
+  bool operator()(const object_holder &optr) const
+  {
+    object_proxy *proxy = detail::object_proxy_accessor().proxy(optr);
+    return proxy != nullptr && operator()(proxy);
+  }
+
+private:
+  typename compiled_traits<T, E>::type evaluator_;
+};
+
+/**
+ * Compiles the given expression for
+ * objects of type T.
+ *
+ * @tparam T The type of the objects
+ * @tparam E The type of the expression
+ * @param expr The expression to compile
+ * @return The compiled expression
+ */
+template < class T, class E >
+compiled_expression<T, E> compile(const E &expr)
+{
+  return compiled_expression<T, E>(expr);
+}
+
 }
 
 #endif /* OBJECT_EXPRESSION_HPP */
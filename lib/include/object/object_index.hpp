@@ -0,0 +1,515 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECT_INDEX_HPP
+#define OBJECT_INDEX_HPP
+
+#ifdef _MSC_VER
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "object/object_expression.hpp"
+#include "object/object_proxy.hpp"
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @brief The kinds of secondary object indexes
+ *
+ * A secondary index maps the value of one member
+ * of an object type to the objects of the type.
+ */
+enum struct t_index_type {
+  UNIQUE,     /**< Hash index allowing each value only once */
+  NON_UNIQUE, /**< Hash index allowing duplicate values */
+  ORDERED     /**< Ordered index allowing duplicate values and range lookups */
+};
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * The comparisons an index lookup can resolve
+ */
+enum struct t_index_op {
+  EQUAL,
+  LESS,
+  LESS_EQUAL,
+  GREATER,
+  GREATER_EQUAL
+};
+
+/**
+ * Maps the comparison functor of an expression
+ * to an index lookup. The reversed op is used
+ * when the constant is the left operand
+ * (i.e. 6 > x means x < 6).
+ */
+template < class OP >
+struct index_op
+{
+  static const bool supported = false;
+  static t_index_op op() { return t_index_op::EQUAL; }
+  static t_index_op reversed() { return t_index_op::EQUAL; }
+};
+
+template < class T >
+struct index_op<std::equal_to<T> >
+{
+  static const bool supported = true;
+  static t_index_op op() { return t_index_op::EQUAL; }
+  static t_index_op reversed() { return t_index_op::EQUAL; }
+};
+
+template < class T >
+struct index_op<std::less<T> >
+{
+  static const bool supported = true;
+  static t_index_op op() { return t_index_op::LESS; }
+  static t_index_op reversed() { return t_index_op::GREATER; }
+};
+
+template < class T >
+struct index_op<std::less_equal<T> >
+{
+  static const bool supported = true;
+  static t_index_op op() { return t_index_op::LESS_EQUAL; }
+  static t_index_op reversed() { return t_index_op::GREATER_EQUAL; }
+};
+
+template < class T >
+struct index_op<std::greater<T> >
+{
+  static const bool supported = true;
+  static t_index_op op() { return t_index_op::GREATER; }
+  static t_index_op reversed() { return t_index_op::LESS; }
+};
+
+template < class T >
+struct index_op<std::greater_equal<T> >
+{
+  static const bool supported = true;
+  static t_index_op op() { return t_index_op::GREATER_EQUAL; }
+  static t_index_op reversed() { return t_index_op::LESS_EQUAL; }
+};
+
+/**
+ * @brief Base class of all secondary object indexes
+ *
+ * An index belongs to the prototype node it was
+ * added to and covers all objects of the node and
+ * its child nodes.
+ *
+ * Modified objects aren't re-keyed immediately.
+ * An object is marked as dirty when it is accessed
+ * for modification through a non const object_ptr
+ * or its modification is recorded by the object_store
+ * (i.e. the update backup of a transaction, its
+ * commit and rollback) and all dirty objects are
+ * re-keyed on the next lookup. An indexed member
+ * changed any other way (i.e. through a kept raw
+ * pointer or a const object_ptr) leaves a stale key
+ * and the object may not be found by lookups. Only objects added with object_store::insert
+ * are keyed immediately (and a unique violation is
+ * reported at once). A modified object violating a
+ * unique index isn't found by lookups until its value
+ * is unique again.
+ */
+class OOS_API basic_object_index
+{
+public:
+  /**
+   * Creates an index
+   *
+   * @param type The type of the index
+   */
+  explicit basic_object_index(t_index_type type);
+  virtual ~basic_object_index();
+
+  basic_object_index(const basic_object_index&) = delete;
+  basic_object_index& operator=(const basic_object_index&) = delete;
+
+  /**
+   * Adds the proxy to the index. The proxy
+   * is keyed on the next lookup.
+   *
+   * @param proxy The proxy to add
+   */
+  void insert(object_proxy *proxy);
+
+  /**
+   * Keys the proxy immediately.
+   *
+   * @param proxy The proxy to key
+   * @throws object_exception if the key violates a unique index
+   */
+  void update(object_proxy *proxy);
+
+  /**
+   * Removes the proxy from the index
+   *
+   * @param proxy The proxy to remove
+   */
+  void remove(object_proxy *proxy);
+
+  /**
+   * Marks the object of the proxy as modified.
+   * The proxy is re-keyed on the next lookup.
+   *
+   * @param proxy The modified proxy
+   */
+  void mark_dirty(object_proxy *proxy);
+
+  /**
+   * Returns the type of the index
+   *
+   * @return The type of the index
+   */
+  t_index_type type() const;
+
+protected:
+  /**
+   * Re-keys all dirty proxies. Proxies without
+   * an object or violating a unique index stay
+   * dirty and unkeyed. Expects the locked mutex.
+   */
+  void refresh();
+
+  /**
+   * Keys the given proxy with the current value
+   * of its object replacing its previous key.
+   *
+   * @param proxy The proxy to key
+   * @return False if the value violates a unique index
+   */
+  virtual bool rekey(object_proxy *proxy) = 0;
+
+  /**
+   * Removes the key of the given proxy
+   *
+   * @param proxy The proxy to remove
+   */
+  virtual void erase(object_proxy *proxy) = 0;
+
+protected:
+  std::mutex mutex_;
+
+private:
+  t_index_type type_;
+  std::unordered_set<object_proxy*> dirty_;
+};
+
+/**
+ * @brief Index over values of type R
+ *
+ * The value_index is the part of an index
+ * an object_view uses for its lookups.
+ *
+ * @tparam R The type of the indexed value
+ */
+template < class R >
+class value_index : public basic_object_index
+{
+public:
+  typedef R value_type; /**< Shortcut to the value type */
+
+  explicit value_index(t_index_type type)
+    : basic_object_index(type)
+  {}
+  virtual ~value_index() {}
+
+  /**
+   * Returns true if the given variable
+   * reads the indexed member
+   *
+   * @param var The variable to check
+   * @return True if the variable reads the indexed member
+   */
+  virtual bool matches(const variable_impl<R> &var) const = 0;
+
+  /**
+   * Returns true if the index can resolve
+   * the given comparison
+   *
+   * @param op The comparison to check
+   * @return True if the comparison is resolvable
+   */
+  bool supports(t_index_op op) const
+  {
+    return op == t_index_op::EQUAL || type() == t_index_type::ORDERED;
+  }
+
+  typedef std::function<bool(object_proxy*)> t_accept_func; /**< Shortcut to the accept predicate */
+
+  /**
+   * Collects all accepted proxies whose value
+   * compares with the given value according to
+   * the given comparison. The proxies are in no
+   * particular order.
+   *
+   * @param value The value to compare with
+   * @param op The comparison
+   * @param accept Predicate accepting the proxies of the caller
+   * @param proxies The vector receiving the found proxies
+   */
+  void find(const R &value, t_index_op op, const t_accept_func &accept, std::vector<object_proxy*> &proxies)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->refresh();
+    collect(value, op, accept, proxies);
+  }
+
+protected:
+  virtual void collect(const R &value, t_index_op op, const t_accept_func &accept, std::vector<object_proxy*> &proxies) const = 0;
+};
+
+/**
+ * @brief Index over a member function of type T
+ *
+ * Stores the values read with the given member
+ * function of the objects. Hash indexes use an
+ * unordered_multimap, ordered indexes a map keyed
+ * by the value and the id of the object.
+ *
+ * @tparam T The type of the indexed prototype
+ * @tparam R The type of the indexed value
+ * @tparam O The type declaring the member function
+ */
+template < class T, class R, class O >
+class member_index : public value_index<R>
+{
+public:
+  typedef R (O::*memfunc_type)() const; /**< Shortcut to the member function */
+
+  member_index(memfunc_type m, t_index_type type)
+    : value_index<R>(type)
+    , m_(m)
+  {}
+  virtual ~member_index() {}
+
+  virtual bool matches(const variable_impl<R> &var) const override
+  {
+    const object_variable_impl<R, O, null_var> *v = dynamic_cast<const object_variable_impl<R, O, null_var>*>(&var);
+    return v != nullptr && v->member() == m_;
+  }
+
+protected:
+  virtual bool rekey(object_proxy *proxy) override
+  {
+    R value = (static_cast<const O*>(static_cast<const T*>(proxy->obj()))->*m_)();
+    auto i = keys_.find(proxy);
+    if (i != keys_.end()) {
+      if (i->second == value) {
+        return true;
+      }
+      erase_value(i->second, proxy);
+      keys_.erase(i);
+    }
+    if (this->type() == t_index_type::UNIQUE && contains(value)) {
+      return false;
+    }
+    insert_value(value, proxy);
+    keys_.insert(std::make_pair(proxy, value));
+    return true;
+  }
+
+  virtual void erase(object_proxy *proxy) override
+  {
+    auto i = keys_.find(proxy);
+    if (i != keys_.end()) {
+      erase_value(i->second, proxy);
+      keys_.erase(i);
+    }
+  }
+
+  virtual bool contains(const R &value) const = 0;
+  virtual void insert_value(const R &value, object_proxy *proxy) = 0;
+  virtual void erase_value(const R &value, object_proxy *proxy) = 0;
+
+private:
+  memfunc_type m_;
+  // the current key of each indexed proxy
+  std::unordered_map<object_proxy*, R> keys_;
+};
+
+template < class T, class R, class O >
+class hash_object_index : public member_index<T, R, O>
+{
+public:
+  typedef typename member_index<T, R, O>::memfunc_type memfunc_type;
+
+  hash_object_index(memfunc_type m, t_index_type type)
+    : member_index<T, R, O>(m, type)
+  {}
+
+protected:
+  typedef typename value_index<R>::t_accept_func t_accept_func;
+
+  virtual void collect(const R &value, t_index_op op, const t_accept_func &accept, std::vector<object_proxy*> &proxies) const override
+  {
+    if (op != t_index_op::EQUAL) {
+      return;
+    }
+    auto range = values_.equal_range(value);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (accept(i->second)) {
+        proxies.push_back(i->second);
+      }
+    }
+  }
+
+  virtual bool contains(const R &value) const override
+  {
+    return values_.find(value) != values_.end();
+  }
+
+  virtual void insert_value(const R &value, object_proxy *proxy) override
+  {
+    values_.insert(std::make_pair(value, proxy));
+  }
+
+  virtual void erase_value(const R &value, object_proxy *proxy) override
+  {
+    auto range = values_.equal_range(value);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (i->second == proxy) {
+        values_.erase(i);
+        return;
+      }
+    }
+  }
+
+private:
+  std::unordered_multimap<R, object_proxy*> values_;
+};
+
+template < class T, class R, class O >
+class ordered_object_index : public member_index<T, R, O>
+{
+public:
+  typedef typename member_index<T, R, O>::memfunc_type memfunc_type;
+
+  explicit ordered_object_index(memfunc_type m)
+    : member_index<T, R, O>(m, t_index_type::ORDERED)
+  {}
+
+protected:
+  typedef typename value_index<R>::t_accept_func t_accept_func;
+
+  virtual void collect(const R &value, t_index_op op, const t_accept_func &accept, std::vector<object_proxy*> &proxies) const override
+  {
+    // equal values are ordered by id, so the
+    // bounds of a value are its lowest and
+    // its highest possible id
+    const t_key lowest(value, 0UL);
+    const t_key highest(value, std::numeric_limits<unsigned long>::max());
+    auto first = values_.begin();
+    auto last = values_.end();
+    switch (op) {
+      case t_index_op::EQUAL:
+        first = values_.lower_bound(lowest);
+        last = values_.upper_bound(highest);
+        break;
+      case t_index_op::LESS:
+        last = values_.lower_bound(lowest);
+        break;
+      case t_index_op::LESS_EQUAL:
+        last = values_.upper_bound(highest);
+        break;
+      case t_index_op::GREATER:
+        first = values_.upper_bound(highest);
+        break;
+      case t_index_op::GREATER_EQUAL:
+        first = values_.lower_bound(lowest);
+        break;
+    }
+    for (; first != last; ++first) {
+      if (accept(first->second)) {
+        proxies.push_back(first->second);
+      }
+    }
+  }
+
+  virtual bool contains(const R &value) const override
+  {
+    auto i = values_.lower_bound(t_key(value, 0UL));
+    return i != values_.end() && !(value < i->first.first);
+  }
+
+  virtual void insert_value(const R &value, object_proxy *proxy) override
+  {
+    values_.insert(std::make_pair(t_key(value, proxy->id()), proxy));
+  }
+
+  virtual void erase_value(const R &value, object_proxy *proxy) override
+  {
+    values_.erase(t_key(value, proxy->id()));
+  }
+
+private:
+  typedef std::pair<R, unsigned long> t_key;
+  std::map<t_key, object_proxy*> values_;
+};
+
+/**
+ * Creates an index of the given type
+ * over the given member function.
+ *
+ * @tparam T The type of the indexed prototype
+ * @tparam R The type of the indexed value
+ * @tparam O The type declaring the member function
+ * @param m The member function reading the value
+ * @param type The type of the index
+ * @return The created index
+ */
+template < class T, class R, class O >
+basic_object_index* make_object_index(R (O::*m)() const, t_index_type type)
+{
+  if (type == t_index_type::ORDERED) {
+    return new ordered_object_index<T, R, O>(m);
+  } else {
+    return new hash_object_index<T, R, O>(m, type);
+  }
+}
+
+/// @endcond
+
+}
+
+}
+
+#endif /* OBJECT_INDEX_HPP */
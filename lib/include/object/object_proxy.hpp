@@ -34,6 +34,7 @@
 #include "tools/identifier_resolver.hpp"
 
 #include "object/prototype_node.hpp"
+#include "object/basic_object_loader.hpp"
 
 #include <ostream>
 #include <set>
@@ -129,6 +130,25 @@ public:
 
   ~object_proxy();
 
+  /**
+   * Allocates the memory for an object_proxy.
+   * All proxies are allocated from slabs, so
+   * proxies created one after another are
+   * adjacent in memory.
+   *
+   * @param size The size of the object_proxy
+   * @return The allocated memory
+   */
+  static void* operator new(std::size_t size);
+
+  /**
+   * Frees the memory of an object_proxy.
+   *
+   * @param p The memory to be freed
+   * @param size The size of the object_proxy
+   */
+  static void operator delete(void *p, std::size_t size);
+
   /**
    * Return the classname/typeid of the object
    *
@@ -340,6 +360,31 @@ public:
    */
   std::shared_ptr<basic_identifier> pk() const;
 
+  /**
+   * Sets the loader which loads the object
+   * on demand if the object_proxy holds only
+   * a primary key.
+   *
+   * @param loader The object loader
+   */
+  void loader(detail::basic_object_loader *loader);
+
+  /**
+   * If the object isn't loaded yet and the
+   * object_proxy has an object loader the
+   * object is loaded. The loader is only
+   * called once.
+   */
+  void load();
+
+  /**
+   * Marks the object as modified in all
+   * secondary indexes covering its prototype
+   * node. The object is re-keyed on the next
+   * index lookup.
+   */
+  void mark_indexes_dirty();
+
 private:
   transaction current_transaction();
   bool has_transaction() const;
@@ -388,6 +433,8 @@ private:
   ptr_set_t ptr_set_;      /**< This set contains every object_holder pointing to this object_proxy. */
   
   std::shared_ptr<basic_identifier> primary_key_ = nullptr;
+
+  detail::basic_object_loader *loader_ = nullptr; /**< Loads the object on demand. */
 };
 /// @endcond
 }
@@ -79,11 +79,13 @@ public:
 
   T* get()
   {
+    proxy_->load();
     return static_cast<T*>(proxy_->obj());
   }
 
   const T* get() const
   {
+    proxy_->load();
     return static_cast<T*>(proxy_->obj());
   }
 
@@ -271,6 +273,9 @@ public:
    * @return The pointer to the serializable of type T.
    */
   T* get() const {
+    if (proxy_) {
+      proxy_->load();
+    }
     return static_cast<T*>(lookup_object());
   }
 
@@ -283,9 +288,16 @@ public:
    * @return The pointer to the serializable of type T.
    */
   T* get() {
+    if (proxy_) {
+      proxy_->load();
+    }
     if (proxy_ && proxy_->obj()) {
       if (proxy_->ostore_ && proxy_->has_transaction()) {
         proxy_->current_transaction().on_update<T>(proxy_);
+      } else if (proxy_->ostore_) {
+        // the object may be modified, so
+        // its index keys are refreshed
+        proxy_->mark_indexes_dirty();
       }
       return (T*)proxy_->obj();
     } else {
@@ -24,19 +24,24 @@
 #include "object/has_one.hpp"
 #include "object/object_serializer.hpp"
 #include "object/basic_has_many.hpp"
+#include "object/object_index.hpp"
 #include "object/transaction.hpp"
 
 #include "tools/sequencer.hpp"
 #include "tools/identifier_setter.hpp"
+#include "tools/rw_mutex.hpp"
 
 #include <memory>
 #include <unordered_map>
 #include <algorithm>
 #include <stack>
+#include <mutex>
+#include <thread>
 
 #include <string>
 #include <ostream>
 #include <list>
+#include <vector>
 #include <iostream>
 
 #ifdef _MSC_VER
@@ -303,6 +308,23 @@ struct null_on_attach : public basic_on_attach
  * Therefor an serializable prototype tree holds the serializable
  * hierarchy representation including a producer class
  * serializable of all known types.
+ *
+ * A store created as concurrent store may be shared
+ * between threads. All modifying methods (attach, insert,
+ * remove, clear, ...) take the exclusive lock of the store.
+ * Threads reading the store (iterating an object_view,
+ * finding or dereferencing objects) hold a shared lock
+ * of the store, i.e. via oos::shared_guard. Objects are
+ * updated while holding the exclusive lock, i.e. via
+ * std::lock_guard. Each thread has its own stack of
+ * transactions.
+ *
+ * A thread holding a shared lock must not modify the
+ * store. This includes objects loaded on demand when
+ * they are accessed the first time, as loading inserts
+ * them into the store. Load them before taking the
+ * shared lock. Taking the exclusive lock while holding
+ * a shared lock deadlocks and is asserted in debug builds.
  */
 class OOS_API object_store
 {
@@ -316,9 +338,12 @@ public:
 
 public:
   /**
-   * Create an empty serializable store.
+   * Create an empty serializable store. If concurrent
+   * is true the store can be shared between threads.
+   *
+   * @param concurrent If true the store synchronizes access
    */
-  object_store();
+  explicit object_store(bool concurrent = false);
 
   /**
    * Destroys all prototypes, objects and observers in store.
@@ -458,7 +483,11 @@ public:
   template<class T>
   iterator find()
   {
-    return find(typeid(T).name());
+    prototype_node *node = find_prototype_node<T>();
+    if (!node) {
+      return end();
+    }
+    return iterator(node);
   }
 
   /**
@@ -474,7 +503,47 @@ public:
   template<class T>
   const_iterator find() const
   {
-    return find(typeid(T).name());
+    prototype_node *node = find_prototype_node<T>();
+    if (!node) {
+      return end();
+    }
+    return const_iterator(node);
+  }
+
+  /**
+   * @brief Adds a secondary index to the prototype of type T
+   *
+   * The index maps the value returned by the given
+   * member function to the objects of type T and of
+   * all its derived types. It is kept up to date on
+   * insertion and removal and when an object is
+   * modified through an object_ptr. An object_view
+   * uses the index to resolve find_if() when the
+   * expression compares the indexed member with a
+   * constant.
+   *
+   * @code
+   * ostore.add_index<person>(&person::name, oos::t_index_type::UNIQUE);
+   * @endcode
+   *
+   * @tparam T The type of the prototype
+   * @tparam R The type of the indexed value
+   * @tparam O The type declaring the member function
+   * @param member The member function returning the value
+   * @param type The type of the index
+   * @throws oos::object_exception if the prototype couldn't be found
+   *         or the existing objects violate a unique index
+   */
+  template < class T, class R, class O >
+  void add_index(R (O::*member)() const, t_index_type type)
+  {
+    static_assert(std::is_base_of<O, T>::value, "member function must belong to the type or one of its bases");
+    std::lock_guard<object_store> guard(*this);
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("couldn't find object type");
+    }
+    node->add_index(detail::make_object_index<T>(member, type));
   }
 
   /**
@@ -597,14 +666,22 @@ public:
   template < class T >
   object_proxy* insert(object_proxy *proxy, bool notify)
   {
+    std::lock_guard<object_store> guard(*this);
     if (proxy == nullptr) {
       throw object_exception("proxy is null");
     }
     if (proxy->obj() == nullptr) {
       throw object_exception("object is null");
     }
-    iterator node = find(proxy->classname());
-    if (node == end()) {
+    // the proxy usually holds an object of type T;
+    // then the node is taken from the types slot
+    prototype_node *node = nullptr;
+    if (proxy->classname() == typeid(T).name()) {
+      node = find_prototype_node<T>();
+    } else {
+      node = find_prototype_node(proxy->classname());
+    }
+    if (node == nullptr) {
       throw object_exception("couldn't find object type");
     }
     // check if proxy/object is already inserted
@@ -628,6 +705,14 @@ public:
     }
 
     node->insert(proxy);
+    try {
+      node->update_indexes(proxy);
+    } catch (...) {
+      node->remove(proxy);
+      proxy->ostore_ = nullptr;
+      proxy->id(0);
+      throw;
+    }
 
     // initialize object
     if (object) {
@@ -635,8 +720,9 @@ public:
     }
     // set this into persistent serializable
     // notify observer
-    if (notify && !transactions_.empty()) {
-      transactions_.top().on_insert<T>(proxy);
+    transaction *tr = top_transaction();
+    if (notify && tr != nullptr) {
+      tr->on_insert<T>(proxy);
     }
 
     // insert element into hash map for fast lookup
@@ -658,6 +744,7 @@ public:
     if (o == nullptr) {
       throw object_exception("object is null");
     }
+    std::lock_guard<object_store> guard(*this);
     object_inserter_.reset();
     std::unique_ptr<object_proxy> proxy(new object_proxy(o));
     try {
@@ -693,6 +780,7 @@ public:
    */
   template<class T>
   bool is_removable(const object_ptr<T> &o) {
+    std::lock_guard<object_store> guard(*this);
     return object_deleter_.is_deletable(o.proxy_, o.get());
   }
 
@@ -701,6 +789,7 @@ public:
   template < class T >
   void remove(object_proxy *proxy, bool notify, bool check_if_deletable)
   {
+    std::lock_guard<object_store> guard(*this);
     if (proxy == nullptr) {
       throw object_exception("object proxy is nullptr");
     }
@@ -733,9 +822,10 @@ public:
 
       proxy->node()->remove(proxy);
 
-      if (notify && !transactions_.empty()) {
+      transaction *tr = top_transaction();
+      if (notify && tr != nullptr) {
         // notify transaction
-        transactions_.top().on_delete<T>(proxy);
+        tr->on_delete<T>(proxy);
       } else {
         delete proxy;
       }
@@ -779,6 +869,7 @@ public:
   template<class T>
   object_proxy *create_proxy(T *o)
   {
+    std::lock_guard<object_store> guard(*this);
     std::unique_ptr<object_proxy> proxy(new object_proxy(o, seq_.next(), this));
     return object_map_.insert(std::make_pair(seq_.current(), proxy.release())).first->second;
   }
@@ -786,6 +877,7 @@ public:
   template<class T>
   object_proxy *create_proxy(T *o, unsigned long oid)
   {
+    std::lock_guard<object_store> guard(*this);
     std::unique_ptr<object_proxy> proxy(new object_proxy(o, oid, this));
     return object_map_.insert(std::make_pair(oid, proxy.release())).first->second;
   }
@@ -853,6 +945,37 @@ public:
   transaction current_transaction();
   bool has_transaction() const;
 
+  /**
+   * Returns true if the store can be
+   * shared between threads.
+   *
+   * @return True if the store synchronizes access
+   */
+  bool is_concurrent() const;
+
+  /**
+   * Acquires the exclusive lock of a concurrent
+   * store. The lock is recursive.
+   */
+  void lock();
+
+  /**
+   * Releases the exclusive lock.
+   */
+  void unlock();
+
+  /**
+   * Acquires a shared lock of a concurrent store.
+   * Many threads can hold a shared lock at the same
+   * time. The shared lock isn't recursive.
+   */
+  void lock_shared() const;
+
+  /**
+   * Releases a shared lock.
+   */
+  void unlock_shared() const;
+
 private:
   friend class detail::modified_marker;
   friend class detail::object_inserter;
@@ -894,8 +1017,10 @@ private:
   template < class T >
   void mark_modified(object_proxy *proxy)
   {
-    if (!transactions_.empty()) {
-      transactions_.top().on_update<T>(proxy);
+    proxy->mark_indexes_dirty();
+    transaction *tr = top_transaction();
+    if (tr != nullptr) {
+      tr->on_update<T>(proxy);
     }
   }
 
@@ -925,6 +1050,40 @@ private:
    */
   prototype_node *find_prototype_node(const char *type) const;
 
+  /**
+   * @internal
+   *
+   * Returns the prototype node of the given type
+   * from the types slot. If the slot isn't set
+   * the node is searched by the typeid name.
+   *
+   * @tparam T Type of the prototype node to search
+   * @return The requested prototype node or nullptr
+   * @throws oos::object_exception if in error occurrs
+   */
+  template<class T>
+  prototype_node *find_prototype_node() const
+  {
+    std::size_t slot = detail::type_slot<T>::index();
+    if (slot < type_slots_.size() && type_slots_[slot] != nullptr) {
+      return type_slots_[slot];
+    }
+    return find_prototype_node(typeid(T).name());
+  }
+
+  /**
+   * @internal
+   *
+   * Updates the given type slot. The slot is only
+   * set if there is exactly one prototype node for
+   * the type. Otherwise a typed lookup falls back
+   * to the lookup by name which detects ambiguous types.
+   *
+   * @param slot The type slot to update
+   * @param nodes All prototype nodes of the slots type
+   */
+  void update_type_slot(std::size_t slot, const std::unordered_map<std::string, prototype_node *> &nodes);
+
   /**
    * @internal
    *
@@ -965,6 +1124,7 @@ private:
 
   void push_transaction(const transaction &tr);
   void pop_transaction();
+  transaction* top_transaction();
 
 private:
   typedef std::unordered_map<std::string, prototype_node *> t_prototype_map;
@@ -983,6 +1143,9 @@ private:
   // prepared prototype nodes
   t_prototype_map prepared_prototype_map_;
 
+  // type slot to prototype node
+  std::vector<prototype_node*> type_slots_;
+
   typedef std::unordered_map<long, object_proxy *> t_object_proxy_map;
   t_object_proxy_map object_map_;
 
@@ -997,12 +1160,23 @@ private:
   // only used when a has_many object is inserted
   abstract_has_many *temp_container_ = nullptr;
 
-  std::stack<transaction> transactions_;
+  typedef std::stack<transaction> t_transaction_stack;
+  t_transaction_stack transactions_;
+
+  // in a concurrent store each thread
+  // has its own transaction stack
+  typedef std::unordered_map<std::thread::id, t_transaction_stack> t_transaction_stack_map;
+  t_transaction_stack_map thread_transactions_;
+  mutable std::mutex transactions_mutex_;
+
+  bool concurrent_ = false;
+  mutable rw_mutex mutex_;
 };
 
 template<class T, template < class ... > class ON_ATTACH, typename Enabled >
 object_store::iterator object_store::attach(const char *type, bool abstract, const char *parent, const ON_ATTACH<T> &on_attach)
 {
+  std::lock_guard<object_store> guard(*this);
   // set node to root node
   prototype_node *parent_node = find_parent(parent);
   /*
@@ -1035,7 +1209,10 @@ object_store::iterator object_store::attach(const char *type, bool abstract, con
   // store prototype in map
   // Todo: check return value
   prototype_map_.insert(std::make_pair(node->type_, node))/*.first*/;
-  typeid_prototype_map_[typeid(T).name()].insert(std::make_pair(node->type_, node));
+  t_prototype_map &typed_nodes = typeid_prototype_map_[typeid(T).name()];
+  typed_nodes.insert(std::make_pair(node->type_, node));
+  node->type_slot_ = detail::type_slot<T>::index();
+  update_type_slot(node->type_slot_, typed_nodes);
 
   on_attach(node);
 
@@ -1051,6 +1228,7 @@ object_store::iterator object_store::attach(const char *type, bool abstract, con
 template<class T>
 prototype_iterator object_store::prepare_attach(bool abstract, const char *parent)
 {
+  std::lock_guard<object_store> guard(*this);
   prototype_node *parent_node = find_parent(parent);
 
   if (typeid_prototype_map_.find(typeid(T).name()) != typeid_prototype_map_.end()) {
@@ -23,9 +23,12 @@
 #include "object/object_ptr.hpp"
 #include "object/object_exception.hpp"
 #include "object/prototype_node.hpp"
+#include "object/object_index.hpp"
 
 #include <sstream>
 #include <algorithm>
+#include <unordered_set>
+#include <vector>
 
 namespace oos {
 
@@ -476,7 +479,7 @@ public:
   object_view(object_store &ostore, bool skip_siblings = false)
     : skip_siblings_(skip_siblings)
   {
-    node_ = ostore.find(typeid(T).name());
+    node_ = ostore.find<T>();
 		if (node_ == ostore.end()) {
       std::stringstream str;
       str << "couldn't find serializable type [" << typeid(T).name() << "]";
@@ -618,7 +621,11 @@ public:
    * @return The size of the object_view.
    */
   size_t size() const {
-    return static_cast<size_t>(std::distance(begin(), end()));
+    if (skip_siblings_) {
+      return node_->count;
+    } else {
+      return subtree_count(node_.get());
+    }
   }
   
   /**
@@ -659,6 +666,144 @@ public:
     return std::find_if(begin(), end(), pred);
   }
 
+  /**
+   * Find serializable which matches the given expression.
+   * The expression is compiled for type T and applied
+   * to the objects of the view in a plain loop.
+   *
+   * @tparam L The type of the left operand
+   * @tparam R The type of the right operand
+   * @tparam OP The type of the operation
+   * @param expr The expression
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class L, class R, class OP >
+  const_iterator find_if(const binary_expression<L, R, OP> &expr) const
+  {
+    return const_iterator(node_, scan(expr), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given expression.
+   * The expression is compiled for type T and applied
+   * to the objects of the view in a plain loop.
+   *
+   * @tparam L The type of the left operand
+   * @tparam R The type of the right operand
+   * @tparam OP The type of the operation
+   * @param expr The expression
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class L, class R, class OP >
+  iterator find_if(const binary_expression<L, R, OP> &expr)
+  {
+    return iterator(node_, scan(expr), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given expression.
+   * The expression is compiled for type T and applied
+   * to the objects of the view in a plain loop.
+   *
+   * @tparam L The type of the operand
+   * @tparam OP The type of the operation
+   * @param expr The expression
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class L, class OP >
+  const_iterator find_if(const unary_expression<L, OP> &expr) const
+  {
+    return const_iterator(node_, scan(expr), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given expression.
+   * The expression is compiled for type T and applied
+   * to the objects of the view in a plain loop.
+   *
+   * @tparam L The type of the operand
+   * @tparam OP The type of the operation
+   * @param expr The expression
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class L, class OP >
+  iterator find_if(const unary_expression<L, OP> &expr)
+  {
+    return iterator(node_, scan(expr), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given comparison.
+   * If a secondary index of the view type or one of its
+   * base types covers the compared member the matching
+   * objects are looked up in the index, otherwise the
+   * view is scanned. Either way the first match in view
+   * order is returned. The index only finds objects whose
+   * indexed member was modified through a non const
+   * object_ptr (see basic_object_index).
+   *
+   * @tparam V The type of the compared value
+   * @tparam OP The type of the comparison
+   * @param expr The comparison of a variable with a constant
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class V, class OP >
+  const_iterator find_if(const binary_expression<variable<V>, V, OP> &expr) const
+  {
+    return const_iterator(node_, find(expr, expr.left(), expr.right().value(), detail::index_op<OP>::supported, detail::index_op<OP>::op()), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given comparison.
+   * If a secondary index of the view type or one of its
+   * base types covers the compared member the matching
+   * objects are looked up in the index, otherwise the
+   * view is scanned. Either way the first match in view
+   * order is returned. The index only finds objects whose
+   * indexed member was modified through a non const
+   * object_ptr (see basic_object_index).
+   *
+   * @tparam V The type of the compared value
+   * @tparam OP The type of the comparison
+   * @param expr The comparison of a variable with a constant
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class V, class OP >
+  iterator find_if(const binary_expression<variable<V>, V, OP> &expr)
+  {
+    return iterator(node_, find(expr, expr.left(), expr.right().value(), detail::index_op<OP>::supported, detail::index_op<OP>::op()), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given comparison
+   * of a constant with a variable (i.e. 6 > x).
+   *
+   * @tparam V The type of the compared value
+   * @tparam OP The type of the comparison
+   * @param expr The comparison of a constant with a variable
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class V, class OP >
+  const_iterator find_if(const binary_expression<V, variable<V>, OP> &expr) const
+  {
+    return const_iterator(node_, find(expr, expr.right(), expr.left().value(), detail::index_op<OP>::supported, detail::index_op<OP>::reversed()), last_proxy());
+  }
+
+  /**
+   * Find serializable which matches the given comparison
+   * of a constant with a variable (i.e. 6 > x).
+   *
+   * @tparam V The type of the compared value
+   * @tparam OP The type of the comparison
+   * @param expr The comparison of a constant with a variable
+   * @return The first iterator with the serializable matching the condition.
+   */
+  template < class V, class OP >
+  iterator find_if(const binary_expression<V, variable<V>, OP> &expr)
+  {
+    return iterator(node_, find(expr, expr.right(), expr.left().value(), detail::index_op<OP>::supported, detail::index_op<OP>::reversed()), last_proxy());
+  }
+
   /**
    * Return the underlaying prototype node
    *
@@ -669,6 +814,100 @@ public:
     return node_.get();
   }
 
+private:
+  // each node counts only its own objects
+  static size_t subtree_count(const prototype_node *node)
+  {
+    size_t count = node->count;
+    for (const prototype_node *child = node->first->next; child != node->last.get(); child = child->next) {
+      count += subtree_count(child);
+    }
+    return count;
+  }
+
+  object_proxy* last_proxy() const
+  {
+    return skip_siblings_ ? node_->op_marker : node_->op_last;
+  }
+
+  /*
+   * Returns the first proxy of the view matching
+   * the expression or the last proxy if none matches.
+   */
+  template < class E >
+  object_proxy* scan(const E &expr) const
+  {
+    compiled_expression<T, E> compiled(expr);
+    object_proxy *last = last_proxy();
+    object_proxy *proxy = node_->op_first->next();
+    while (proxy != last && !compiled(proxy)) {
+      proxy = proxy->next();
+    }
+    return proxy;
+  }
+
+  /*
+   * Returns the first proxy of the view matching
+   * the comparison of the variable with the value
+   * or the last proxy if none matches. The matching
+   * proxies are taken from an index if there is one.
+   */
+  template < class E, class V >
+  object_proxy* find(const E &expr, const variable<V> &var, const V &value, bool supported, detail::t_index_op op) const
+  {
+    std::vector<object_proxy*> proxies;
+    if (!find_indexed(var, value, supported, op, proxies)) {
+      return scan(expr);
+    }
+    // a stale key must not deliver an object
+    // which doesn't match anymore
+    compiled_expression<T, E> compiled(expr);
+    proxies.erase(std::remove_if(proxies.begin(), proxies.end(), [&compiled](object_proxy *proxy) {
+      return !compiled(proxy);
+    }), proxies.end());
+    if (proxies.empty()) {
+      return last_proxy();
+    }
+    if (proxies.size() == 1) {
+      return proxies.front();
+    }
+    // the index isn't in view order
+    std::unordered_set<object_proxy*> matches(proxies.begin(), proxies.end());
+    object_proxy *last = last_proxy();
+    object_proxy *proxy = node_->op_first->next();
+    while (proxy != last && matches.find(proxy) == matches.end()) {
+      proxy = proxy->next();
+    }
+    return proxy;
+  }
+
+  /*
+   * Looks for an index of the view node or of one
+   * of its parent nodes which resolves the comparison
+   * and collects the matching proxies of the view.
+   * Returns false if there is no such index.
+   */
+  template < class V >
+  bool find_indexed(const variable<V> &var, const V &value, bool supported, detail::t_index_op op, std::vector<object_proxy*> &proxies) const
+  {
+    if (!supported) {
+      return false;
+    }
+    for (prototype_node *node = node_.get(); node != nullptr; node = node->parent) {
+      for (auto &idx : node->indexes_) {
+        detail::value_index<V> *index = dynamic_cast<detail::value_index<V>*>(idx.get());
+        if (index == nullptr || !index->supports(op) || !index->matches(var.impl())) {
+          continue;
+        }
+        index->find(value, op, [this](object_proxy *proxy) {
+          return skip_siblings_ ? proxy->node() == node_.get() : proxy->node()->is_child_of(node_.get());
+        }, proxies);
+        return true;
+      }
+    }
+    return false;
+  }
+
 private:
     bool skip_siblings_;
     prototype_iterator node_;
@@ -41,12 +41,51 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace oos {
 
 class object_store;
 class object_proxy;
 
+namespace detail {
+
+/// @cond OOS_DEV
+
+class basic_object_index;
+
+/**
+ * Returns the next unused type slot.
+ * Slots start with one, zero means no slot.
+ *
+ * @return The next unused type slot
+ */
+OOS_API std::size_t next_type_slot();
+
+/**
+ * @brief Provides a process wide unique slot per type
+ *
+ * The slot is assigned on first request and
+ * is used by the object_store as index into a
+ * dense array of prototype nodes. That way a
+ * typed lookup doesn't need to hash the type name.
+ *
+ * @tparam T The type to get the slot for
+ */
+template < class T >
+struct type_slot
+{
+  static std::size_t index()
+  {
+    static const std::size_t slot = next_type_slot();
+    return slot;
+  }
+};
+
+/// @endcond
+
+}
+
 /**
  * @class prototype_node
  * @brief Holds the prototype of a concrete serializable.
@@ -83,17 +122,7 @@ public:
    * @param type_id The type id of this node.
    * @param abstract Tells the node if its prototype is abstract.
    */
-  prototype_node(object_store *tree, const char *type, const std::type_info &typeinfo, bool abstract = false)
-    : tree_(tree)
-    , first(new prototype_node)
-    , last(new prototype_node)
-    , type_(type)
-    , abstract_(abstract)
-    , type_index_(typeinfo)
-  {
-    first->next = last.get();
-    last->prev = first.get();
-  }
+  prototype_node(object_store *tree, const char *type, const std::type_info &typeinfo, bool abstract = false);
 
 
   ~prototype_node();
@@ -179,6 +208,35 @@ public:
    */
   void clear(bool recursive);
 
+  /**
+   * Adds a secondary index to the node. The
+   * node takes the ownership of the index. The
+   * index covers the objects of this node and
+   * all child nodes. All existing objects are
+   * added to the index.
+   *
+   * @param index The index to add
+   * @throws object_exception if the existing objects violate a unique index
+   */
+  void add_index(detail::basic_object_index *index);
+
+  /**
+   * Keys the given proxy in all indexes
+   * covering this node immediately.
+   *
+   * @param proxy The proxy to key
+   * @throws object_exception if the proxy violates a unique index
+   */
+  void update_indexes(object_proxy *proxy);
+
+  /**
+   * Marks the given proxy as modified in
+   * all indexes covering this node.
+   *
+   * @param proxy The modified proxy
+   */
+  void mark_indexes_dirty(object_proxy *proxy);
+
   /**
    * Unlinks node from list.
    */
@@ -320,7 +378,9 @@ public:
 
   /**
    * Find the underlying proxy of the given primary key.
-   * If no proxy is found nullptr is returned
+   * The lookup is done via the hashed identifier map of
+   * this node and of all child nodes. If no proxy is
+   * found nullptr is returned
    *
    * @param pk The primary key
    * @return The corresponding object_proxy or nullptr
@@ -399,6 +459,15 @@ private:
 
   std::type_index type_index_; /**< type index of the represented object type */
 
+  std::size_t type_slot_ = 0; /**< slot of the represented object type in the object_store (0 means none) */
+
+  /**
+   * The secondary indexes declared for this node. The
+   * objects of a node are part of the indexes of the
+   * node and of all its parent nodes.
+   */
+  std::vector<std::unique_ptr<detail::basic_object_index> > indexes_;
+
   /**
    * Holds the primary keys of all proxies in this node
    */
@@ -182,6 +182,17 @@ public:
   void on_insert(object_proxy *proxy);
   template < class T >
   void on_update(object_proxy *proxy);
+  /**
+   * Notifies the transaction about an object
+   * which is already modified. If the object
+   * wasn't modified before in this transaction
+   * all of its fields are written on commit.
+   *
+   * @tparam T The type of the object
+   * @param proxy The proxy of the modified object
+   */
+  template < class T >
+  void on_modified(object_proxy *proxy);
   template < class T >
   void on_delete(object_proxy *proxy);
 
@@ -270,9 +281,10 @@ void transaction::on_update(object_proxy *proxy)
    * is restored to old values
    *
    *****************/
+  // the object is about to be modified
+  proxy->mark_indexes_dirty();
   if (transaction_data_->id_action_index_map_.find(proxy->id()) == transaction_data_->id_action_index_map_.end()) {
-    std::shared_ptr<update_action> ua(new update_action(proxy, (T*)proxy->obj()));
-    backup(ua, proxy);
+    backup(std::make_shared<update_action>(proxy, (T*)proxy->obj()), proxy);
   } else {
     // An serializable with that id already exists
     // do nothing because the serializable is already
@@ -280,6 +292,16 @@ void transaction::on_update(object_proxy *proxy)
   }
 }
 
+template < class T >
+void transaction::on_modified(object_proxy *proxy)
+{
+  proxy->mark_indexes_dirty();
+  if (transaction_data_->id_action_index_map_.find(proxy->id()) == transaction_data_->id_action_index_map_.end()) {
+    // the fields before the modification are unknown
+    backup(std::make_shared<update_action>(proxy, (T*)proxy->obj(), false), proxy);
+  }
+}
+
 template < class T >
 void transaction::on_delete(object_proxy *proxy)
 {
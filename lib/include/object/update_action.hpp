@@ -7,6 +7,7 @@
 
 #include "object/action.hpp"
 #include "object/delete_action.hpp"
+#include "object/field_snapshot.hpp"
 
 namespace oos {
 
@@ -28,20 +29,30 @@ class OOS_API update_action : public action
 private:
   typedef void (*t_backup_func)(byte_buffer&, update_action*, object_serializer &serializer);
   typedef void (*t_restore_func)(byte_buffer&, update_action*, object_store*, object_serializer &serializer);
+  typedef delete_action* (*t_delete_func)(update_action*);
 
 public:
   /**
-   * Creates an update_action.
+   * Creates an update_action. If the object isn't
+   * modified yet a snapshot of its fields is taken,
+   * so the modified fields can be determined.
    *
+   * @param proxy The proxy of the updated serializable.
    * @param o The updated serializable.
+   * @param unmodified True if the object isn't modified yet.
    */
   template < class T >
-  update_action(object_proxy *proxy, T *obj)
+  update_action(object_proxy *proxy, T *o, bool unmodified = true)
     : proxy_(proxy)
-    , delete_action_(new delete_action(proxy, obj))
     , backup_func_(&backup_update<T, object_serializer>)
     , restore_func_(&restore_update<T, object_serializer>)
-  {}
+    , delete_func_(&create_delete<T>)
+    , has_snapshot_(unmodified)
+  {
+    if (unmodified) {
+      snapshot_.take(*o);
+    }
+  }
 
   virtual void accept(action_visitor *av);
 
@@ -59,7 +70,30 @@ public:
 
   virtual void restore(byte_buffer &buffer, object_store *store);
 
-  delete_action* release_delete_action();
+  /**
+   * Creates a delete action for the updated
+   * object. The delete action restores the
+   * object from the backup of this action.
+   *
+   * @return The created delete action
+   */
+  delete_action* create_delete_action();
+
+  /**
+   * Returns true if the action holds a snapshot
+   * of the fields before the modification.
+   *
+   * @return True if there is a snapshot
+   */
+  bool has_snapshot() const;
+
+  /**
+   * Returns the snapshot of the fields
+   * before the modification.
+   *
+   * @return The snapshot of the fields
+   */
+  detail::field_snapshot& snapshot();
 
 private:
   template < class T, class S >
@@ -74,14 +108,24 @@ private:
   {
     T* obj = (T*)(act->proxy()->obj());
     serializer.deserialize(obj, &buffer, store);
+    act->proxy()->mark_indexes_dirty();
+  }
+
+  template < class T >
+  static delete_action* create_delete(update_action *act)
+  {
+    return new delete_action(act->proxy(), (T*)act->proxy()->obj());
   }
 
 private:
   object_proxy *proxy_;
-  std::unique_ptr<delete_action> delete_action_;
 
   t_backup_func backup_func_;
   t_restore_func restore_func_;
+  t_delete_func delete_func_;
+
+  bool has_snapshot_;
+  detail::field_snapshot snapshot_;
 };
 
 /// @endcond
@@ -19,9 +19,12 @@
 #endif
 
 #include "object/identifier_proxy_map.hpp"
+#include "object/basic_object_loader.hpp"
+#include "object/field_snapshot.hpp"
 
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace oos {
 
@@ -32,6 +35,9 @@ namespace detail {
 template < class T >
 class relation_resolver;
 
+template < class V >
+class eager_value;
+
 /// @endcond
 
 }
@@ -47,12 +53,13 @@ class persistence;
  * This class acts as a base class for all kind
  * of tables (common table and relation table)
  */
-class OOS_API basic_table
+class OOS_API basic_table : public detail::basic_object_loader
 {
 public:
   typedef std::shared_ptr<basic_table> table_ptr;                                             /**< Shortcut to table shared pointer */
   typedef std::unordered_map<std::string, table_ptr> t_table_map;                             /**< Shortcut to an unordered map of table shared pointer*/
   typedef std::unordered_map<std::string, detail::t_identifier_multimap> t_relation_item_map; /**< Shortcut to an unordered identifier multimap */
+  typedef std::function<void(const std::string&, unsigned long)> t_load_progress_func;         /**< Shortcut to the load progress callback (table name, loaded rows) */
 
 public:
   /**
@@ -98,12 +105,61 @@ public:
   /**
    * @brief Interface for loading a table
    *
-   * Interface for loading a table into the
-   * given object_store.
+   * Interface for loading a table from the given
+   * database connection into the given object_store.
+   *
+   * @param conn The database connection
+   * @param p The object_store to load the table into
+   */
+  virtual void load(connection &conn, object_store &p) = 0;
+
+  /**
+   * @brief Loads a table chunk by chunk
+   *
+   * Loads the table into the given object_store reading
+   * at most chunk_size rows per database query. After each
+   * chunk the progress callback (if set) is called with the
+   * name of the table and the count of rows loaded so far.
+   *
+   * The default implementation loads the table with one
+   * query and reports the progress once.
+   *
+   * @param conn The database connection
+   * @param p The object_store to load the table into
+   * @param chunk_size The maximum count of rows per query (0 means all rows at once)
+   * @param progress The progress callback
+   */
+  virtual void load_chunked(connection &conn, object_store &p, std::size_t chunk_size, const t_load_progress_func &progress);
+
+  /**
+   * @brief Reads the rows of the table without loading them
+   *
+   * Reads all rows of the table from the given connection
+   * and keeps the created objects until merge_fetched() is
+   * called. Neither the object_store nor any other table is
+   * touched, so different tables may be fetched at the same
+   * time on different connections.
+   *
+   * The default implementation reads nothing. The table is
+   * then loaded on merge_fetched().
+   *
+   * @param conn The database connection
+   * @param chunk_size The maximum count of rows per query (0 means all rows at once)
+   * @param progress The progress callback
+   */
+  virtual void fetch(connection &conn, std::size_t chunk_size, const t_load_progress_func &progress);
+
+  /**
+   * @brief Loads the fetched objects into the object_store
+   *
+   * Inserts the objects read by fetch() into the given
+   * object_store and resolves their relations. The default
+   * implementation loads the table on the connection of
+   * the persistence object.
    *
    * @param p The object_store to load the table into
    */
-  virtual void load(object_store &p) = 0;
+  virtual void merge_fetched(object_store &p);
 
   /**
    * @brief Interface for inserting an object
@@ -111,9 +167,22 @@ public:
    * Interface for inserting an object represented
    * by the given object_proxy
    *
+   * @param conn The database connection
    * @param proxy The proxy representing the object to be inserted
    */
-  virtual void insert(object_proxy *proxy) = 0;
+  virtual void insert(connection &conn, object_proxy *proxy) = 0;
+
+  /**
+   * @brief Inserts a batch of objects at once
+   *
+   * Inserts all objects represented by the given
+   * object proxies. The default implementation
+   * inserts each object on its own.
+   *
+   * @param conn The database connection
+   * @param proxies The proxies representing the objects to be inserted
+   */
+  virtual void insert_batch(connection &conn, const std::vector<object_proxy*> &proxies);
 
   /**
    * @brief Interface for updating an object
@@ -121,9 +190,25 @@ public:
    * Interface for updating an object represented
    * by the given object_proxy
    *
+   * @param conn The database connection
+   * @param proxy The proxy representing the object to be updated
+   */
+  virtual void update(connection &conn, object_proxy *proxy) = 0;
+
+  /**
+   * @brief Updates the modified columns of an object
+   *
+   * Compares the object represented by the given
+   * object_proxy with the snapshot of its fields
+   * taken before the modification and updates only
+   * the modified columns. The default implementation
+   * updates the whole object.
+   *
+   * @param conn The database connection
    * @param proxy The proxy representing the object to be updated
+   * @param snapshot The fields before the modification
    */
-  virtual void update(object_proxy *proxy) = 0;
+  virtual void update_modified(connection &conn, object_proxy *proxy, detail::field_snapshot &snapshot);
 
   /**
    * @brief Interface for deleting an object
@@ -131,9 +216,49 @@ public:
    * Interface for deleting an object represented
    * by the given object_proxy
    *
+   * @param conn The database connection
    * @param proxy The proxy representing the object to be deleted
    */
-  virtual void remove(object_proxy *proxy) = 0;
+  virtual void remove(connection &conn, object_proxy *proxy) = 0;
+
+  /**
+   * @brief Deletes a batch of objects at once
+   *
+   * Deletes all objects represented by the given
+   * object proxies. The default implementation
+   * deletes each object on its own.
+   *
+   * @param conn The database connection
+   * @param proxies The proxies representing the objects to be deleted
+   */
+  virtual void remove_batch(connection &conn, const std::vector<object_proxy*> &proxies);
+
+  /**
+   * @brief Loads a single object on demand
+   *
+   * Loads the object identified by the primary
+   * key of the given proxy on the connection of
+   * the persistence object. Loading holds the
+   * exclusive lock of the object store, so sessions
+   * of different threads load one after another.
+   * The proxy doesn't know the session dereferencing
+   * it, so a session on a pooled connection loads on
+   * the persistence connection as well.
+   * The default implementation does nothing.
+   *
+   * @param proxy The proxy to load the object for
+   */
+  virtual void load_object(object_proxy *proxy) override;
+
+  /**
+   * @brief Called after a rolled back commit
+   *
+   * The database state written by the rolled back
+   * statements isn't known anymore. A table keeping
+   * state about its rows must rebuild it. The default
+   * implementation does nothing.
+   */
+  virtual void on_rollback();
 
   /**
    * @brief Returns true if the table is laready loaded
@@ -147,6 +272,8 @@ protected:
 
   template < class T >
   friend class detail::relation_resolver;
+  template < class V >
+  friend class detail::eager_value;
   template < class T >
   friend class relation_table;
   friend class persistence;
@@ -156,8 +283,41 @@ protected:
   t_table_map::iterator begin_table();
   t_table_map::iterator end_table();
 
+  connection& conn();
+
+  prototype_node* node() const;
+
+  /**
+   * Prepares the statements of the table for the
+   * given connection. Statements which aren't
+   * prepared are prepared on their first use.
+   *
+   * @param conn The database connection
+   */
   virtual void prepare(connection &conn) = 0;
 
+  /**
+   * Returns the key under which the prepared
+   * statements of this table are cached within
+   * a connection. The key is unique for each
+   * table object.
+   *
+   * @return The statement cache key
+   */
+  unsigned long statement_cache_key() const;
+
+  /**
+   * Returns the maximum count of rows written with
+   * one multi row statement for a table of the given
+   * count of columns. The rows are limited by the
+   * count of host variables supported by all
+   * databases (999 for older SQLite versions).
+   *
+   * @param column_count The count of columns of a row
+   * @return The maximum count of rows of one statement
+   */
+  static std::size_t max_batch_rows(std::size_t column_count);
+
   virtual void append_relation_items(const std::string &id, detail::t_identifier_map &identifier_proxy_map, basic_table::t_relation_item_map &has_many_relations);
 
   persistence &persistence_;
@@ -172,6 +332,7 @@ protected:
 
 private:
   prototype_node *node_;
+  unsigned long statement_cache_key_;
 };
 
 }
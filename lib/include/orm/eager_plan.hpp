@@ -0,0 +1,414 @@
+#ifndef OOS_EAGER_PLAN_HPP
+#define OOS_EAGER_PLAN_HPP
+
+#include "tools/access.hpp"
+#include "tools/cascade_type.hpp"
+#include "tools/identifier_resolver.hpp"
+
+#include "object/has_one.hpp"
+#include "object/object_exception.hpp"
+#include "object/object_store.hpp"
+
+#include "orm/basic_table.hpp"
+#include "orm/identifier_column_resolver.hpp"
+
+#include "sql/column_serializer.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace oos {
+
+template < class T >
+class table;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief The objects of one part read from one row
+ *
+ * Holds the object of a joined table read from
+ * one result row and the objects of the tables
+ * joined to it.
+ */
+class basic_eager_value
+{
+public:
+  virtual ~basic_eager_value() {}
+
+  /**
+   * Reads the columns of the object followed by
+   * the columns of the joined objects from the
+   * current row of the result.
+   *
+   * @param s The serializer reading the result
+   */
+  virtual void read(serializer &s) = 0;
+
+  /**
+   * Inserts the joined objects and the read object
+   * into the store. If the row held no object
+   * nothing is inserted.
+   *
+   * @param owner The table of the owner
+   * @param store The store to insert into
+   */
+  virtual void insert(basic_table &owner, object_store &store) = 0;
+};
+
+typedef std::vector<std::unique_ptr<basic_eager_value>> t_eager_value_vector;
+
+class basic_eager_part;
+
+typedef std::vector<std::unique_ptr<basic_eager_part>> t_eager_part_vector;
+
+/**
+ * @brief One has one field fetched with its owner
+ *
+ * The part holds the table and the columns of the
+ * object referenced by a has one field. The columns
+ * are qualified with the table name so they can be
+ * selected from the joined tables. The has one fields
+ * of the referenced object fetched as well are the
+ * parts of this part.
+ */
+class basic_eager_part
+{
+public:
+  basic_eager_part(const std::string &foreign_column, const std::string &table_name)
+    : foreign_column_(foreign_column)
+    , table_name_(table_name)
+  {}
+
+  virtual ~basic_eager_part() {}
+
+  /**
+   * Returns the qualified column of the owner
+   * table holding the foreign key.
+   *
+   * @return The foreign key column
+   */
+  const std::string& foreign_column() const { return foreign_column_; }
+
+  /**
+   * Returns the name of the joined table
+   *
+   * @return The name of the joined table
+   */
+  const std::string& table_name() const { return table_name_; }
+
+  /**
+   * Returns the qualified primary key
+   * column of the joined table.
+   *
+   * @return The primary key column
+   */
+  const std::string& id_column() const { return id_column_; }
+
+  /**
+   * Returns the qualified columns
+   * of the joined table.
+   *
+   * @return The columns of the joined table
+   */
+  const std::vector<std::string>& columns() const { return columns_; }
+
+  /**
+   * Returns the parts joined to the
+   * table of this part.
+   *
+   * @return The parts joined to this part
+   */
+  const t_eager_part_vector& parts() const { return parts_; }
+
+  /**
+   * Sets the parts joined to the
+   * table of this part.
+   *
+   * @param parts The parts joined to this part
+   */
+  void parts(t_eager_part_vector &&parts) { parts_ = std::move(parts); }
+
+  /**
+   * Creates the holder of the objects
+   * of this part for the next row.
+   *
+   * @return The created value
+   */
+  virtual basic_eager_value* create_value() const = 0;
+
+protected:
+  void add_columns(oos::columns &cols, const column &id)
+  {
+    for (const std::shared_ptr<column> &col : cols.columns_) {
+      columns_.push_back(table_name_ + "." + col->name);
+    }
+    id_column_ = table_name_ + "." + id.name;
+  }
+
+private:
+  std::string foreign_column_;
+  std::string table_name_;
+  std::string id_column_;
+  std::vector<std::string> columns_;
+  t_eager_part_vector parts_;
+};
+
+inline void create_eager_values(const t_eager_part_vector &parts, t_eager_value_vector &values)
+{
+  values.clear();
+  values.reserve(parts.size());
+  for (const std::unique_ptr<basic_eager_part> &part : parts) {
+    values.emplace_back(part->create_value());
+  }
+}
+
+template < class V >
+class eager_value : public basic_eager_value
+{
+public:
+  eager_value(const std::string &table_name, const t_eager_part_vector &parts)
+    : obj_(new V)
+    , table_name_(table_name)
+  {
+    create_eager_values(parts, values_);
+  }
+
+  virtual void read(serializer &s) override
+  {
+    oos::access::serialize(s, *obj_);
+    for (std::unique_ptr<basic_eager_value> &value : values_) {
+      value->read(s);
+    }
+  }
+
+  virtual void insert(basic_table &owner, object_store &store) override
+  {
+    // a left join without a match
+    // delivers a null primary key
+    std::unique_ptr<basic_identifier> id(identifier_resolver<V>::resolve(obj_.get()));
+    if (!id || !id->is_valid()) {
+      obj_.reset();
+      return;
+    }
+    // the referenced objects are inserted first,
+    // so the object is resolved to them
+    for (std::unique_ptr<basic_eager_value> &value : values_) {
+      value->insert(owner, store);
+    }
+    basic_table::t_table_map::iterator i = owner.find_table(table_name_);
+    if (i == owner.end_table()) {
+      throw_object_exception("unknown table " << table_name_);
+    }
+    static_cast<table<V>&>(*i->second).insert_loaded(obj_.release(), store);
+  }
+
+private:
+  std::unique_ptr<V> obj_;
+  std::string table_name_;
+  t_eager_value_vector values_;
+};
+
+template < class V >
+class eager_part : public basic_eager_part
+{
+public:
+  eager_part(const std::string &foreign_column, const std::string &table_name)
+    : basic_eager_part(foreign_column, table_name)
+  {
+    V obj;
+    column_serializer serializer(oos::columns::WITHOUT_BRACKETS);
+    std::unique_ptr<oos::columns> cols(serializer.execute(obj));
+    add_columns(*cols, identifier_column_resolver::resolve<V>());
+  }
+
+  virtual basic_eager_value* create_value() const override
+  {
+    return new eager_value<V>(table_name(), parts());
+  }
+};
+
+/**
+ * @brief An object read with its joined objects
+ *
+ * Holds an object of T and the joined objects read
+ * from the same row until they are inserted into
+ * the store. Without joined tables only the object
+ * is held.
+ *
+ * @tparam T The type of the object
+ */
+template < class T >
+struct eager_object
+{
+  eager_object() {}
+  explicit eager_object(const t_eager_part_vector &parts)
+    : obj(new T)
+  {
+    create_eager_values(parts, values);
+  }
+
+  std::unique_ptr<T> obj;
+  t_eager_value_vector values;
+};
+
+/**
+ * @brief A result row of an object and its joined objects
+ *
+ * The row reads the columns of the object followed
+ * by the columns of each joined object.
+ *
+ * @tparam T The type of the object
+ */
+template < class T >
+class eager_row
+{
+public:
+  eager_row() {}
+  explicit eager_row(eager_object<T> *object)
+    : object_(object)
+  {}
+
+  template < class S >
+  void serialize(S &s)
+  {
+    oos::access::serialize(s, *object_->obj);
+    for (std::unique_ptr<basic_eager_value> &value : object_->values) {
+      value->read(s);
+    }
+  }
+
+private:
+  eager_object<T> *object_ = nullptr;
+};
+
+/**
+ * @brief Builds the parts of an eager fetch plan
+ *
+ * Creates one part for each of the given has one
+ * fields of type T. A field may be a path of has
+ * one fields separated by dots (i.e. "customer.address"),
+ * then the parts of the following fields are joined
+ * to the part of the first field. Each table may
+ * appear only once in a plan and must differ from
+ * the table of T.
+ *
+ * @tparam T The type of the object
+ */
+template < class T >
+class eager_plan_builder
+{
+public:
+  eager_plan_builder(object_store &store, const std::string &table_name, const std::vector<std::string> &fields)
+    : store_(store)
+    , table_name_(table_name)
+    , fields_(fields)
+    , joined_tables_(&own_joined_tables_)
+  {
+    own_joined_tables_.push_back(table_name);
+  }
+
+  t_eager_part_vector build()
+  {
+    t_eager_part_vector parts;
+    parts_ = &parts;
+    matched_fields_ = 0;
+    T obj;
+    oos::access::serialize(*this, obj);
+    parts_ = nullptr;
+    if (matched_fields_ != fields_.size()) {
+      throw_object_exception("unknown has one field of " << table_name_);
+    }
+    return parts;
+  }
+
+  template < class V >
+  void serialize(V &x)
+  {
+    oos::access::serialize(*this, x);
+  }
+
+  template < class V >
+  void serialize(const char *, V &) { }
+
+  void serialize(const char *, char *, size_t) { }
+
+  template < class V >
+  void serialize(const char *id, has_one<V> &, cascade_type)
+  {
+    // the remaining paths of the
+    // fields starting with this one
+    std::vector<std::string> nested_fields;
+    std::size_t matched = 0;
+    std::string prefix(std::string(id) + ".");
+    for (const std::string &field : fields_) {
+      if (field == id) {
+        ++matched;
+      } else if (field.compare(0, prefix.size(), prefix) == 0) {
+        nested_fields.push_back(field.substr(prefix.size()));
+        ++matched;
+      }
+    }
+    if (matched == 0) {
+      return;
+    }
+    matched_fields_ += matched;
+
+    prototype_iterator node = store_.find<V>();
+    if (node == store_.end()) {
+      throw_object_exception("unknown type of has one field " << id);
+    }
+    std::string table_name(node->type());
+    if (table_name == joined_tables_->front()) {
+      throw_object_exception("table " << table_name << " can't be joined to itself");
+    }
+    if (std::find(joined_tables_->begin(), joined_tables_->end(), table_name) != joined_tables_->end()) {
+      throw_object_exception("table " << table_name << " can't be joined twice");
+    }
+    joined_tables_->push_back(table_name);
+
+    std::unique_ptr<basic_eager_part> part(new eager_part<V>(table_name_ + "." + id, table_name));
+    if (!nested_fields.empty()) {
+      eager_plan_builder<V> builder(store_, table_name, nested_fields, joined_tables_);
+      part->parts(builder.build());
+    }
+    parts_->push_back(std::move(part));
+  }
+
+  template < class HAS_MANY >
+  void serialize(const char *, HAS_MANY &, const char *, const char *) { }
+
+private:
+  template < class V >
+  friend class eager_plan_builder;
+
+  eager_plan_builder(object_store &store, const std::string &table_name, const std::vector<std::string> &fields, std::vector<std::string> *joined_tables)
+    : store_(store)
+    , table_name_(table_name)
+    , fields_(fields)
+    , joined_tables_(joined_tables)
+  {}
+
+private:
+  object_store &store_;
+  std::string table_name_;
+  const std::vector<std::string> &fields_;
+  t_eager_part_vector *parts_ = nullptr;
+  std::size_t matched_fields_ = 0;
+
+  // the tables of the whole plan, the first
+  // one is the table of the plan's object
+  std::vector<std::string> own_joined_tables_;
+  std::vector<std::string> *joined_tables_;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_EAGER_PLAN_HPP
@@ -63,11 +63,14 @@ public:
    * @brief Creates a new persistence object
    *
    * Creates a new persistence object for the given
-   * database connection string.
+   * database connection string. If concurrent is true
+   * the object_store can be shared between threads,
+   * i.e. by sessions running on pooled connections.
    *
    * @param dns The database connection string
+   * @param concurrent If true the object_store synchronizes access
    */
-  explicit persistence(const std::string &dns);
+  explicit persistence(const std::string &dns, bool concurrent = false);
   ~persistence();
 
   /**
@@ -101,6 +104,31 @@ public:
   template<class T, class S>
   void attach(const char *type, bool abstract = false);
 
+  /**
+   * @brief Fetches the object of a has one field eagerly
+   *
+   * The objects referenced by the given has one field
+   * of type T are read together with the objects of T
+   * in one statement joining both tables. This applies
+   * to loading the table of T as a whole (also chunked
+   * or in parallel) and to loading a single object of T
+   * on demand. A path of has one fields separated by
+   * dots (i.e. "customer.address") joins the tables of
+   * all fields on the path.
+   *
+   * @tparam T The type of the object holding the field
+   * @param field The name or path of the has one field
+   */
+  template < class T >
+  void fetch_eager(const std::string &field)
+  {
+    t_table_map::iterator i = tables_.find(store_.type<T>());
+    if (i == tables_.end()) {
+      throw_object_exception("couldn't find table of type " << store_.type<T>());
+    }
+    static_cast<table<T>&>(*i->second).fetch_eager(field);
+  }
+
   /**
    * Checks if the given entity as
    * table exists
@@ -313,7 +341,7 @@ persistence_on_attach<has_many_item<T>>::persistence_on_attach(const persistence
   : basic_persistence_on_attach(x.persistence_)
 {
   V owner;
-  owner_type_ = persistence_.get().store().find(typeid(V).name())->type();
+  owner_type_ = persistence_.get().store().find<V>()->type();
   oos::access::serialize(*this, owner);
 }
 
@@ -75,15 +75,22 @@ public:
        * if proxy can't be found we create
        * a proxy and store it in tables
        * proxy map. it will be used when
-       * table is read.
+       * table is read or the object is
+       * accessed the first time.
        */
-      proxy = new object_proxy(pk, (T*)nullptr, node.get());
       basic_table::t_table_map::iterator j = table_.find_table(node->type());
 
       if (j == table_.end_table()) {
         throw_object_exception("unknown table " << node->type());
       }
-      j->second->identifier_proxy_map_.insert(std::make_pair(pk, proxy));
+      auto k = j->second->identifier_proxy_map_.find(pk);
+      if (k != j->second->identifier_proxy_map_.end()) {
+        proxy = k->second;
+      } else {
+        proxy = new object_proxy(pk, (T*)nullptr, node.get());
+        proxy->loader(j->second.get());
+        j->second->identifier_proxy_map_.insert(std::make_pair(pk, proxy));
+      }
       x.reset(proxy, cascade);
     }
   }
@@ -124,6 +131,13 @@ public:
     } else {
       table_.has_many_relations_.insert(std::make_pair(id, detail::t_identifier_multimap()));
       j->second->identifier_proxy_map_.insert(std::make_pair(id_, proxy_));
+      // load relation table on first access,
+      // always on the persistence connection
+      basic_table::table_ptr relation_table = j->second;
+      object_store *store = store_;
+      x.loader([relation_table, store]() {
+        relation_table->load(relation_table->conn(), *store);
+      });
     }
   }
 
@@ -7,11 +7,19 @@
 #include "sql/query.hpp"
 
 #include "object/basic_has_many.hpp"
+#include "object/object_view.hpp"
 #include "object/object_proxy_accessor.hpp"
 
 #include "tools/basic_identifier.hpp"
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #ifndef OOS_RELATION_TABLE_HPP
 #define OOS_RELATION_TABLE_HPP
@@ -56,96 +64,387 @@ public:
 
   virtual void prepare(connection &conn) override
   {
-    query<relation_type> q(name());
-
-    select_all_ = q.select({owner_id_column_, item_id_column_}).prepare(conn);
-    insert_ = q.insert(item_).prepare(conn);
-
-    column owner_id(owner_id_column_);
-    column item_id(item_id_column_);
-
-    update_ = q.update(item_).where(owner_id == 1 && item_id == 1).limit(1).prepare(conn);
-    delete_ = q.remove().where(owner_id == 1 && item_id == 1).limit(1).prepare(conn);
+    statements(conn);
+    owner_table();
+  }
 
-    // find owner table
-    auto tid = find_table(owner_type_);
-    if (tid == end_table()) {
-      // Todo: introduce throw_orm_exception
-      throw std::logic_error("no owner table " + owner_type_ + " found");
+  virtual void load(connection &conn, object_store &store) override
+  {
+    std::lock_guard<object_store> guard(store);
+    if (is_loaded_) {
+      return;
+    }
+    table_ptr owner = owner_table();
+    // all rows are read before the items are
+    // inserted, inserting may run further
+    // statements on the connection
+    std::vector<std::unique_ptr<relation_type>> items;
+    {
+      auto res = select_all(conn);
+
+      auto first = res.begin();
+      auto last = res.end();
+
+      while (first != last) {
+        items.emplace_back(first.release());
+        ++first;
+      }
+    }
+    clear_row_counts();
+    for (std::unique_ptr<relation_type> &item : items) {
+      insert_loaded(item.release(), store, *owner);
     }
-    owner_table_ = tid->second;
+
+    append_to_owners(*owner);
   }
 
-  virtual void load(object_store &store) override
+  virtual void fetch(connection &conn, std::size_t, const t_load_progress_func &progress) override
   {
+    fetched_.clear();
     if (is_loaded_) {
       return;
     }
-    auto res = select_all_.execute();
-
-    // set explicit creator function
-    relation_type item(item_);
-    auto func = [item]() {
-      relation_type *i = new relation_type(item.owner_id(), item.item_id(), item.owner()->clone());
-      return i;
-    };
-    res.creator(func);
+    auto res = select_all(conn);
 
     auto first = res.begin();
     auto last = res.end();
 
     while (first != last) {
-      // create new proxy of relation object
-      proxy_.reset(new object_proxy(first.release()));
+      fetched_.emplace_back(first.release());
       ++first;
-      object_proxy *proxy = store.insert<relation_type>(proxy_.release(), false);
-      resolver_.resolve(proxy, &store);
-
-      // append item to owner table
-      auto i = owner_table_->has_many_relations_.find(relation_id_);
-      if (i == owner_table_->has_many_relations_.end()) {
-        i = owner_table_->has_many_relations_.insert(
-        std::make_pair(relation_id_, detail::t_identifier_multimap())).first;
-      }
-      i->second.insert(std::make_pair(proxy->obj<relation_type>()->owner(), proxy));
     }
+    if (progress) {
+      progress(name(), fetched_.size());
+    }
+  }
 
-    if (owner_table_->is_loaded()) {
-      // append items
-      owner_table_->append_relation_items(relation_id_, identifier_proxy_map_, owner_table_->has_many_relations_);
+  virtual void merge_fetched(object_store &store) override
+  {
+    std::lock_guard<object_store> guard(store);
+    if (is_loaded_) {
+      fetched_.clear();
+      return;
+    }
+    table_ptr owner = owner_table();
+    clear_row_counts();
+    for (std::unique_ptr<relation_type> &item : fetched_) {
+      insert_loaded(item.release(), store, *owner);
     }
+    fetched_.clear();
 
-    is_loaded_ = true;
+    append_to_owners(*owner);
   }
 
-  virtual void insert(object_proxy *proxy) override
+  virtual void insert(connection &conn, object_proxy *proxy) override
   {
-    insert_.bind((relation_type*)proxy->obj(), 0);
+    statement<relation_type> &stmt = statements(conn).insert;
+    stmt.bind((relation_type*)proxy->obj(), 0);
     // Todo: check result
-    insert_.execute();
+    stmt.execute();
+    count_row((relation_type*)proxy->obj(), 1);
+  }
+
+  virtual void insert_batch(connection &conn, const std::vector<object_proxy*> &proxies) override
+  {
+    if (proxies.empty()) {
+      return;
+    }
+    relation_statements &stmts = statements(conn);
+    // a relation row has an owner and an item column
+    std::size_t rows = std::min(proxies.size(), max_batch_rows(2));
+    if (rows != stmts.insert_batch_rows) {
+      // the count of value lists is part of the
+      // statement, so prepare again if it changes
+      query<relation_type> q(name());
+      stmts.insert_batch = q.insert(item_, rows).prepare(conn);
+      stmts.insert_batch_rows = rows;
+    }
+    auto first = proxies.begin();
+    while (static_cast<std::size_t>(proxies.end() - first) >= rows) {
+      size_t pos = 0;
+      for (auto i = first; i != first + rows; ++i) {
+        pos = stmts.insert_batch.bind((relation_type*)(*i)->obj(), pos);
+      }
+      // Todo: check result
+      stmts.insert_batch.execute();
+      for (auto i = first; i != first + rows; ++i) {
+        count_row((relation_type*)(*i)->obj(), 1);
+      }
+      first += rows;
+    }
+    // insert the remaining items one by one
+    while (first != proxies.end()) {
+      insert(conn, *first++);
+    }
+  }
+
+  virtual void update(connection &, object_proxy *) override
+  {
+    // a relation row consists of its key columns
+    // only, an update would find the row by the
+    // values it writes. so there is nothing to do
   }
 
-  virtual void update(object_proxy *proxy) override
+  virtual void remove(connection &conn, object_proxy *proxy) override
   {
-    size_t pos = update_.bind((relation_type*)proxy->obj(), 0);
-    update_.bind((relation_type*)proxy->obj(), pos);
+    statement<relation_type> &stmt = statements(conn).remove;
+    stmt.bind((relation_type*)proxy->obj(), 0);
+    stmt.execute();
+    count_row((relation_type*)proxy->obj(), -1);
+  }
 
-    update_.execute();
+  virtual void on_rollback() override
+  {
+    // the database state isn't known anymore,
+    // take the rows from the items in the store
+    std::lock_guard<std::mutex> lock(row_counts_mutex_);
+    row_counts_.clear();
+    const object_view<relation_type> items(*node()->tree(), true);
+    for (auto first = items.begin(); first != items.end(); ++first) {
+      relation_type *item = (relation_type*)proxy(first.optr())->obj();
+      if (item != nullptr && item->owner()) {
+        ++row_counts_[item->owner()][value_key(item)];
+      }
+    }
   }
 
-  virtual void remove(object_proxy *proxy) override
+  virtual void remove_batch(connection &conn, const std::vector<object_proxy*> &proxies) override
   {
-    delete_.bind((relation_type*)proxy->obj(), 0);
-    delete_.execute();
+    /*
+     * the rows of a relation can't be told apart if
+     * an owner holds the same value more than once.
+     * the values of an owner still held by another
+     * item are deleted row by row, all other values
+     * of the owner are deleted with one statement
+     */
+    t_owner_map owners;
+    for (object_proxy *proxy : proxies) {
+      relation_type *item = (relation_type*)proxy->obj();
+      owner_items &items = owners[item->owner()];
+      items.proxies.push_back(proxy);
+      ++items.removed[value_key(item)];
+    }
+    find_kept_values(owners);
+
+    std::vector<object_proxy*> removable;
+    for (auto &owner : owners) {
+      removable.clear();
+      for (object_proxy *proxy : owner.second.proxies) {
+        if (owner.second.kept.count(value_key((relation_type*)proxy->obj())) > 0) {
+          remove(conn, proxy);
+        } else {
+          removable.push_back(proxy);
+        }
+      }
+      if (removable.size() == 1) {
+        remove(conn, removable.front());
+      } else if (!removable.empty()) {
+        remove_values(conn, removable);
+      }
+    }
   }
 
 private:
-  relation_type item_;
+  /*
+   * the statements of the relation table
+   * prepared for one connection
+   */
+  struct relation_statements : public detail::basic_statement_cache
+  {
+    statement<relation_type> select_all;
+    statement<relation_type> insert;
+    statement<relation_type> update;
+    statement<relation_type> remove;
+    statement<relation_type> insert_batch;
+    statement<relation_type> remove_batch;
+
+    std::size_t insert_batch_rows = 0;
+    std::size_t remove_batch_rows = 0;
+  };
+
+  /*
+   * the items are compared by their value,
+   * object values by their proxy
+   */
+  typedef typename std::conditional<std::is_scalar<T>::value, T, object_proxy*>::type t_value_key;
+
+  struct owner_items
+  {
+    std::vector<object_proxy*> proxies;
+    std::map<t_value_key, std::size_t> removed;
+    std::set<t_value_key> kept;
+  };
+
+  typedef std::unordered_map<
+    detail::identifier_ptr, owner_items,
+    detail::identifier_hash<detail::identifier_ptr>, detail::identifier_equal
+  > t_owner_map;
+
+  // the count of rows of each value of an owner
+  typedef std::unordered_map<
+    detail::identifier_ptr, std::map<t_value_key, std::size_t>,
+    detail::identifier_hash<detail::identifier_ptr>, detail::identifier_equal
+  > t_row_count_map;
+
+  t_value_key value_key(relation_type *item)
+  {
+    return value_key(item, std::is_scalar<T>());
+  }
+
+  t_value_key value_key(relation_type *item, std::true_type)
+  {
+    return item->value();
+  }
 
-  statement<relation_type> select_all_;
-  statement<relation_type> insert_;
-  statement<relation_type> update_;
-  statement<relation_type> delete_;
+  t_value_key value_key(relation_type *item, std::false_type)
+  {
+    return proxy(item->value());
+  }
+
+  void find_kept_values(t_owner_map &owners)
+  {
+    // a value is kept if the owner has more
+    // rows of it than the batch removes
+    std::lock_guard<std::mutex> lock(row_counts_mutex_);
+    for (auto &owner : owners) {
+      auto i = row_counts_.find(owner.first);
+      if (i == row_counts_.end()) {
+        continue;
+      }
+      for (auto &removed : owner.second.removed) {
+        auto j = i->second.find(removed.first);
+        if (j != i->second.end() && j->second > removed.second) {
+          owner.second.kept.insert(removed.first);
+        }
+      }
+    }
+  }
+
+  void count_row(relation_type *item, int delta)
+  {
+    if (item == nullptr || !item->owner()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(row_counts_mutex_);
+    if (delta > 0) {
+      ++row_counts_[item->owner()][value_key(item)];
+      return;
+    }
+    auto i = row_counts_.find(item->owner());
+    if (i == row_counts_.end()) {
+      return;
+    }
+    auto j = i->second.find(value_key(item));
+    if (j != i->second.end() && --j->second == 0) {
+      i->second.erase(j);
+      if (i->second.empty()) {
+        row_counts_.erase(i);
+      }
+    }
+  }
+
+  void clear_row_counts()
+  {
+    std::lock_guard<std::mutex> lock(row_counts_mutex_);
+    row_counts_.clear();
+  }
+
+  void remove_values(connection &conn, const std::vector<object_proxy*> &proxies)
+  {
+    relation_statements &stmts = statements(conn);
+    if (proxies.size() != stmts.remove_batch_rows) {
+      // the count of values is part of the
+      // statement, so prepare again if it changes
+      query<relation_type> q(name());
+      column owner_id(owner_id_column_);
+      column item_id(item_id_column_);
+      stmts.remove_batch = q.remove().where(owner_id == 1 && in(item_id, std::vector<int>(proxies.size(), 1))).prepare(conn);
+      stmts.remove_batch_rows = proxies.size();
+    }
+    // bind the owner once followed by the values
+    static const std::vector<bool> owner_field = { true, false };
+    static const std::vector<bool> item_field = { false, true };
+    size_t pos = stmts.remove_batch.bind((relation_type*)proxies.front()->obj(), owner_field, 0);
+    for (object_proxy *proxy : proxies) {
+      pos = stmts.remove_batch.bind((relation_type*)proxy->obj(), item_field, pos);
+    }
+    stmts.remove_batch.execute();
+    for (object_proxy *proxy : proxies) {
+      count_row((relation_type*)proxy->obj(), -1);
+    }
+  }
+
+  relation_statements& statements(connection &conn)
+  {
+    detail::basic_statement_cache *cache = conn.statement_cache(statement_cache_key());
+    if (cache == nullptr) {
+      std::unique_ptr<relation_statements> stmts(new relation_statements);
+      query<relation_type> q(name());
+
+      stmts->select_all = q.select({owner_id_column_, item_id_column_}).prepare(conn, t_result_mode::STREAMED);
+      stmts->insert = q.insert(item_).prepare(conn);
+
+      column owner_id(owner_id_column_);
+      column item_id(item_id_column_);
+
+      stmts->update = q.update(item_).where(owner_id == 1 && item_id == 1).limit(1).prepare(conn);
+      stmts->remove = q.remove().where(owner_id == 1 && item_id == 1).limit(1).prepare(conn);
+      cache = conn.statement_cache(statement_cache_key(), std::move(stmts));
+    }
+    return static_cast<relation_statements&>(*cache);
+  }
+
+  result<relation_type> select_all(connection &conn)
+  {
+    auto res = statements(conn).select_all.execute();
+
+    // set explicit creator function
+    relation_type item(item_);
+    auto func = [item]() {
+      relation_type *i = new relation_type(item.owner_id(), item.item_id(), item.owner()->clone());
+      return i;
+    };
+    res.creator(func);
+    return res;
+  }
+
+  void insert_loaded(relation_type *item, object_store &store, basic_table &owner)
+  {
+    // create new proxy of relation object
+    proxy_.reset(new object_proxy(item));
+    object_proxy *proxy = store.insert<relation_type>(proxy_.release(), false);
+    resolver_.resolve(proxy, &store);
+
+    // append item to owner table
+    auto i = owner.has_many_relations_.find(relation_id_);
+    if (i == owner.has_many_relations_.end()) {
+      i = owner.has_many_relations_.insert(
+      std::make_pair(relation_id_, detail::t_identifier_multimap())).first;
+    }
+    i->second.insert(std::make_pair(proxy->obj<relation_type>()->owner(), proxy));
+    count_row(proxy->obj<relation_type>(), 1);
+  }
+
+  void append_to_owners(basic_table &owner)
+  {
+    // append items to all owners waiting for them
+    owner.append_relation_items(relation_id_, identifier_proxy_map_, owner.has_many_relations_);
+
+    is_loaded_ = true;
+  }
+
+  table_ptr owner_table()
+  {
+    auto tid = find_table(owner_type_);
+    if (tid == end_table()) {
+      // Todo: introduce throw_orm_exception
+      throw std::logic_error("no owner table " + owner_type_ + " found");
+    }
+    return tid->second;
+  }
+
+private:
+  relation_type item_;
 
   std::string owner_id_column_;
   std::string item_id_column_;
@@ -156,7 +455,12 @@ private:
 
   std::unique_ptr<object_proxy> proxy_;
 
-  table_ptr owner_table_;
+  // items read by fetch() waiting to be merged
+  std::vector<std::unique_ptr<relation_type>> fetched_;
+
+  // the rows on the database known to the table
+  t_row_count_map row_counts_;
+  std::mutex row_counts_mutex_;
 };
 
 /// @endcond
@@ -24,6 +24,8 @@
 
 #include "orm/persistence.hpp"
 
+#include "sql/connection_pool.hpp"
+
 namespace oos {
 
 /**
@@ -52,6 +54,28 @@ namespace oos {
  *
  * This session can also load the whole database into
  * the underlying object_store.
+ *
+ * By default a session uses the connection of the
+ * persistence object. A session may also run on any
+ * other connection to the same database, i.e. one
+ * taken from a connection_pool, so that sessions in
+ * different threads don't share one connection.
+ * Objects loaded on demand are read on the connection
+ * of the persistence object while holding the exclusive
+ * lock of the object store, whichever session dereferenced
+ * them. A session on the persistence connection doesn't
+ * take that lock while committing, so as long as other
+ * threads may load on demand all sessions should run on
+ * pooled connections.
+ *
+ * @code
+ *
+ * oos::connection_pool pool(<database connection string>, 4);
+ * oos::connection_pool::pooled_connection conn = pool.acquire();
+ *
+ * oos::session s(p, *conn);
+ *
+ * @endcode
  */
 class OOS_API session
 {
@@ -59,10 +83,26 @@ public:
   /**
    * @brief Creates a new session object from persistence
    *
+   * The session runs on the connection of the
+   * persistence object, which is shared with
+   * objects loaded on demand.
+   *
    * @param p The persistence object.
    */
   explicit session(persistence &p);
 
+  /**
+   * @brief Creates a new session object on the given connection
+   *
+   * The connection must be open and refer to the
+   * database of the persistence object. It must
+   * outlive the session.
+   *
+   * @param p The persistence object.
+   * @param conn The connection to use
+   */
+  session(persistence &p, connection &conn);
+
   /**
    * @brief Inserts an object.
    *
@@ -100,12 +140,13 @@ public:
   template < class T >
   object_ptr<T> update(const object_ptr<T> &optr)
   {
+    // the object is already modified
     if (store().has_transaction()) {
-      store().current_transaction().on_update<T>(optr.proxy_);
+      store().current_transaction().on_modified<T>(optr.proxy_);
     } else {
       transaction tr(persistence_.store(), observer_);
       tr.begin();
-      tr.on_update<T>(optr.proxy_);
+      tr.on_modified<T>(optr.proxy_);
       tr.commit();
     }
     return optr;
@@ -262,6 +303,61 @@ public:
    */
   void load();
 
+  /**
+   * @brief Loads all tables from database chunk by chunk.
+   *
+   * Loads all tables from database. Each table is read
+   * in chunks of at most chunk_size rows ordered by the
+   * primary key, so the database result never holds more
+   * than one chunk. Relations are resolved while loading.
+   * After each chunk the given progress callback is called
+   * with the name of the table and the count of loaded rows.
+   *
+   * @param chunk_size The maximum count of rows per query (0 means all rows at once)
+   * @param progress The progress callback
+   */
+  void load(std::size_t chunk_size, const basic_table::t_load_progress_func &progress = nullptr);
+
+  /**
+   * @brief Loads all tables from database in parallel.
+   *
+   * Reads the tables at the same time, each table on
+   * one connection taken from the given pool. At most
+   * as many threads as the pool holds connections are
+   * started. The read objects are inserted into the
+   * object_store and their relations are resolved
+   * afterwards in one pass on the calling thread.
+   *
+   * The progress callback is called from the reading
+   * threads, but never concurrently.
+   *
+   * @param pool The pool providing the connections
+   * @param chunk_size The maximum count of rows per query (0 means all rows at once)
+   * @param progress The progress callback
+   */
+  void load(connection_pool &pool, std::size_t chunk_size = 0, const basic_table::t_load_progress_func &progress = nullptr);
+
+  /**
+   * @brief Loads the table of the given type from database.
+   *
+   * Loads only the table of the given type. Objects
+   * of other tables referenced by the loaded objects
+   * are loaded on first access of the object or the
+   * has many container.
+   *
+   * @tparam T The type of the table to load
+   */
+  template < class T >
+  void load()
+  {
+    persistence::t_table_map::iterator i = persistence_.find_table(store().type<T>());
+    if (i == persistence_.end()) {
+      // Todo: replace with persistence exception
+      throw object_exception("couldn't find table");
+    }
+    load(i->second, 0, nullptr);
+  }
+
   /**
    * @brief Starts a transaction.
    *
@@ -269,6 +365,30 @@ public:
    */
   transaction begin();
 
+  /**
+   * @brief Sets the insert batch size
+   *
+   * On commit the inserted objects of one type are
+   * written with one multi row insert statement per
+   * batch. A batch size of one inserts each object
+   * on its own. Consecutive deletions of one type are
+   * passed in batches of the same size to the table.
+   *
+   * The rows of one statement are limited by the
+   * count of host variables of the database, so
+   * batches of wide tables are split.
+   *
+   * @param size The count of objects inserted at once
+   */
+  void insert_batch_size(std::size_t size);
+
+  /**
+   * @brief Returns the insert batch size
+   *
+   * @return The count of objects inserted at once
+   */
+  std::size_t insert_batch_size() const;
+
   /**
    * @brief Return a reference to the underlaying object_store
    *
@@ -283,8 +403,17 @@ public:
    */
   const object_store& store() const;
 
+  /**
+   * @brief Returns the connection of the session
+   *
+   * @return The connection of the session
+   */
+  connection& conn();
+
 private:
-  void load(const persistence::table_ptr &table);
+  void load(const persistence::table_ptr &table, std::size_t chunk_size, const basic_table::t_load_progress_func &progress);
+
+  std::vector<persistence::table_ptr> tables_to_load();
 
 private:
   class session_observer : public transaction::observer, public action_visitor
@@ -298,12 +427,26 @@ private:
     virtual void visit(insert_action *act);
     virtual void visit(update_action *act);
     virtual void visit(delete_action *act);
+  private:
+    void flush_deletes();
+
   private:
     session &session_;
+    std::vector<object_proxy*> batch_;
+
+    // consecutive deletions of one table
+    // waiting to be written as one batch,
+    // they are written before any other
+    // action to keep the order of the actions
+    persistence::table_ptr delete_table_;
+    std::vector<delete_action*> deletes_;
   };
 
 private:
   persistence &persistence_;
+  connection &connection_;
+
+  std::size_t insert_batch_size_ = 50;
 
   std::shared_ptr<transaction::observer> observer_;
 
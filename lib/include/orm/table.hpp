@@ -7,8 +7,10 @@
 
 #include "object/object_proxy.hpp"
 #include "object/object_store.hpp"
+#include "object/field_snapshot.hpp"
 
 #include "orm/basic_table.hpp"
+#include "orm/eager_plan.hpp"
 #include "orm/identifier_binder.hpp"
 #include "orm/identifier_column_resolver.hpp"
 #include "orm/relation_resolver.hpp"
@@ -16,6 +18,12 @@
 
 #include "sql/query.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace oos {
 
 class connection;
@@ -45,6 +53,7 @@ public:
   table(prototype_node *node, persistence &p)
     : basic_table(node, p)
     , resolver_(*this)
+    , column_count_(count_columns())
   { }
 
   virtual ~table() {}
@@ -61,58 +70,239 @@ public:
     stmt.drop().execute(conn);
   }
 
-  virtual void load(object_store &store) override
+  /**
+   * @brief Fetches the object of a has one field eagerly
+   *
+   * The objects of the given has one field are read
+   * together with the objects of this table. The table
+   * of the field is joined with a left join, so the
+   * whole table (also chunked or fetched in parallel)
+   * and each object loaded on demand are read with
+   * their referenced objects in one statement.
+   *
+   * The field may be a path of has one fields separated
+   * by dots, i.e. "customer.address" joins the customers
+   * and their addresses.
+   *
+   * A table can only be joined once and not to itself.
+   * For an unknown field an object_exception is thrown.
+   *
+   * @param field The name or path of the has one field
+   */
+  void fetch_eager(const std::string &field)
   {
-    auto result = select_.execute();
+    if (std::find(eager_fields_.begin(), eager_fields_.end(), field) != eager_fields_.end()) {
+      return;
+    }
+    eager_fields_.push_back(field);
+    try {
+      eager_parts_ = detail::eager_plan_builder<T>(*node()->tree(), name(), eager_fields_).build();
+    } catch (...) {
+      eager_fields_.pop_back();
+      throw;
+    }
+    ++eager_version_;
+  }
 
-    auto first = result.begin();
-    auto last = result.end();
-
-    while (first != last) {
-      // try to find object proxy by id
-      std::shared_ptr<basic_identifier> id(identifier_resolver_.resolve_object(first.get()));
-
-      detail::t_identifier_map::iterator i = identifier_proxy_map_.find(id);
-      if (i != identifier_proxy_map_.end()) {
-        // use proxy;
-        proxy_.reset(i->second);
-        proxy_->reset(first.release(), false);
-        identifier_proxy_map_.erase(i);
-      } else {
-        // create new proxy
-        proxy_.reset(new object_proxy(first.release()));
+  virtual void load(connection &conn, object_store &store) override
+  {
+    std::lock_guard<object_store> guard(store);
+    if (!eager_fields_.empty()) {
+      load_eager(conn, store);
+      return;
+    }
+    // all rows are read before the objects are
+    // inserted, inserting may run further
+    // statements on the connection
+    std::vector<std::unique_ptr<T>> objects;
+    {
+      auto result = statements(conn).select.execute();
+
+      auto first = result.begin();
+      auto last = result.end();
+
+      while (first != last) {
+        objects.emplace_back(first.release());
+        ++first;
+      }
+    }
+    for (std::unique_ptr<T> &obj : objects) {
+      insert_loaded(obj.release(), store);
+    }
+
+    // mark table as loaded
+    is_loaded_ = true;
+  }
+
+  virtual void load_chunked(connection &conn, object_store &store, std::size_t chunk_size, const t_load_progress_func &progress) override
+  {
+    if (chunk_size == 0) {
+      basic_table::load_chunked(conn, store, chunk_size, progress);
+      return;
+    }
+    std::lock_guard<object_store> guard(store);
+    read_chunked(conn, chunk_size, progress, [this, &store](detail::eager_object<T> &object) {
+      return insert_eager(object, store)->template obj<T>();
+    });
+
+    // mark table as loaded
+    is_loaded_ = true;
+  }
+
+  virtual void fetch(connection &conn, std::size_t chunk_size, const t_load_progress_func &progress) override
+  {
+    fetched_.clear();
+    if (chunk_size > 0) {
+      read_chunked(conn, chunk_size, progress, [this](detail::eager_object<T> &object) {
+        T *obj = object.obj.get();
+        fetched_.push_back(std::move(object));
+        return obj;
+      });
+      return;
+    }
+    if (!eager_fields_.empty()) {
+      table_statements &stmts = statements(conn);
+      prepare_eager(conn, stmts);
+
+      auto result = stmts.select_eager.execute();
+      read_eager(result, fetched_);
+    } else {
+      auto result = statements(conn).select.execute();
+
+      auto first = result.begin();
+      auto last = result.end();
+
+      while (first != last) {
+        fetched_.emplace_back();
+        fetched_.back().obj.reset(first.release());
+        ++first;
       }
+    }
+    if (progress) {
+      progress(name(), fetched_.size());
+    }
+  }
 
-      ++first;
-      object_proxy *proxy = store.insert<T>(proxy_.release(), false);
-      resolver_.resolve(proxy, &store);
+  virtual void merge_fetched(object_store &store) override
+  {
+    std::lock_guard<object_store> guard(store);
+    for (detail::eager_object<T> &object : fetched_) {
+      insert_eager(object, store);
     }
+    fetched_.clear();
 
     // mark table as loaded
     is_loaded_ = true;
   }
 
-  virtual void insert(object_proxy *proxy) override
+  virtual void load_object(object_proxy *proxy) override
+  {
+    object_store *store = proxy->ostore();
+    if (store == nullptr) {
+      return;
+    }
+    // the persistence connection and the
+    // placeholder proxies of the tables are
+    // shared by all sessions
+    std::lock_guard<object_store> guard(*store);
+    if (!eager_fields_.empty()) {
+      load_object_eager(proxy, *store);
+      return;
+    }
+    statement<T> &select_by_id = statements(conn()).select_by_id;
+    select_by_id.reset();
+    select_by_id.bind(*proxy->pk(), 0);
+
+    auto result = select_by_id.execute();
+
+    auto first = result.begin();
+    T *obj = nullptr;
+    if (first != result.end()) {
+      obj = first.release();
+    }
+    // release the statement before any
+    // further object is loaded
+    select_by_id.reset();
+
+    if (obj != nullptr) {
+      insert_loaded(obj, *store);
+    }
+  }
+
+  virtual void insert(connection &conn, object_proxy *proxy) override
   {
-    insert_.bind((T*)proxy->obj(), 0);
+    statement<T> &stmt = statements(conn).insert;
+    stmt.bind((T*)proxy->obj(), 0);
     // Todo: check result
-    insert_.execute();
+    stmt.execute();
+  }
+
+  virtual void insert_batch(connection &conn, const std::vector<object_proxy*> &proxies) override
+  {
+    if (proxies.empty()) {
+      return;
+    }
+    table_statements &stmts = statements(conn);
+    if (stmts.insert.max_parameter_sets() > 1) {
+      // the objects are bound as parameter sets
+      // of the single row insert statement
+      insert_parameter_sets(stmts, proxies);
+      return;
+    }
+    // the rows of one statement are limited
+    // by the count of host variables
+    std::size_t rows = std::min(proxies.size(), max_batch_rows(column_count_));
+    prepare_insert_batch(conn, stmts, rows);
+
+    auto first = proxies.begin();
+    while (static_cast<std::size_t>(proxies.end() - first) >= rows) {
+      size_t pos = 0;
+      for (auto i = first; i != first + rows; ++i) {
+        pos = stmts.insert_batch.bind((T*)(*i)->obj(), pos);
+      }
+      // Todo: check result
+      stmts.insert_batch.execute();
+      first += rows;
+    }
+    // insert the remaining objects one by one
+    while (first != proxies.end()) {
+      insert(conn, *first++);
+    }
   }
 
-  virtual void update(object_proxy *proxy) override
+  virtual void update(connection &conn, object_proxy *proxy) override
+  {
+    update_all(statements(conn), (T*)proxy->obj());
+  }
+
+  virtual void update_modified(connection &conn, object_proxy *proxy, detail::field_snapshot &snapshot) override
   {
     T *obj = (T*)proxy->obj();
-    size_t pos = update_.bind(obj, 0);
-    binder_.bind(obj, &update_, pos);
-    // Todo: check result
-    update_.execute();
+    detail::field_snapshot::t_field_mask fields = snapshot.modified(*obj);
+
+    std::size_t count = std::count(fields.begin(), fields.end(), true);
+    if (count == 0) {
+      // nothing to write
+      return;
+    }
+    table_statements &stmts = statements(conn);
+    if (count == fields.size()) {
+      update_all(stmts, obj);
+    } else {
+      statement<T> &stmt = prepare_update(conn, stmts, obj, fields);
+      size_t pos = stmt.bind(obj, fields, 0);
+      stmts.binder.bind(obj, &stmt, pos);
+      // Todo: check result
+      stmt.execute();
+    }
   }
 
-  virtual void remove(object_proxy *proxy) override
+  virtual void remove(connection &conn, object_proxy *proxy) override
   {
-    binder_.bind((T*)proxy->obj(), &delete_, 0);
+    table_statements &stmts = statements(conn);
+    stmts.binder.bind((T*)proxy->obj(), &stmts.remove, 0);
     // Todo: check result
-    delete_.execute();
+    stmts.remove.execute();
   }
 
 protected:
@@ -122,23 +312,21 @@ protected:
    * Prepares the table object for the given connection.
    * Subsequently some prepared statements are created:
    * - select
+   * - select by identifier
    * - insert
    * - update
    * - delete
    *
-   * These statements will be used on the provide
-   * methods.
+   * These statements are kept in the statement cache
+   * of the connection and used on the provided methods.
+   * Without calling prepare they are created on the
+   * first use of the connection.
    *
    * @param conn The database connection
    */
   virtual void prepare(connection &conn) override
   {
-    query<T> q(name());
-    insert_ = q.insert().prepare(conn);
-    column id = detail::identifier_column_resolver::resolve<T>();
-    update_ = q.update().where(id == 1).prepare(conn);
-    delete_ = q.remove().where(id == 1).prepare(conn);
-    select_ = q.select().prepare(conn);
+    statements(conn);
   }
 
   /**
@@ -156,19 +344,402 @@ protected:
   }
 
 private:
-  detail::identifier_binder<T> binder_;
+  template < class V >
+  friend class detail::eager_value;
+
+  /*
+   * the statements of the table prepared
+   * for one connection
+   */
+  struct table_statements : public detail::basic_statement_cache
+  {
+    detail::identifier_binder<T> binder;
+
+    statement<T> insert;
+    statement<T> insert_batch;
+    statement<T> update;
+    statement<T> remove;
+    statement<T> select;
+    statement<T> select_by_id;
+    statement<T> select_first_chunk;
+    statement<T> select_next_chunk;
+
+    std::unordered_map<detail::field_snapshot::t_field_mask, statement<T>> update_fields;
+
+    statement<detail::eager_row<T>> select_eager;
+    statement<detail::eager_row<T>> select_eager_by_id;
+    statement<detail::eager_row<T>> select_eager_first_chunk;
+    statement<detail::eager_row<T>> select_eager_next_chunk;
+
+    std::size_t chunk_size = 0;
+    std::size_t insert_batch_rows = 0;
+    std::size_t eager_version = 0;
+  };
+
+  table_statements& statements(connection &conn)
+  {
+    detail::basic_statement_cache *cache = conn.statement_cache(statement_cache_key());
+    if (cache == nullptr) {
+      std::unique_ptr<table_statements> stmts(new table_statements);
+      query<T> q(name());
+      stmts->insert = q.insert().prepare(conn);
+      column id = detail::identifier_column_resolver::resolve<T>();
+      stmts->update = q.update().where(id == 1).prepare(conn);
+      stmts->remove = q.remove().where(id == 1).prepare(conn);
+      // a table is read as a whole, so its
+      // rows are streamed instead of buffered.
+      // all rows are read before any object
+      // is inserted into the store
+      stmts->select = q.select().prepare(conn, t_result_mode::STREAMED);
+      stmts->select_by_id = q.select().where(id == 1).prepare(conn);
+      cache = conn.statement_cache(statement_cache_key(), std::move(stmts));
+    }
+    return static_cast<table_statements&>(*cache);
+  }
+
+  void load_eager(connection &conn, object_store &store)
+  {
+    table_statements &stmts = statements(conn);
+    prepare_eager(conn, stmts);
+
+    std::vector<detail::eager_object<T>> objects;
+    {
+      auto result = stmts.select_eager.execute();
+      read_eager(result, objects);
+    }
+    for (detail::eager_object<T> &object : objects) {
+      insert_eager(object, store);
+    }
+
+    // mark table as loaded
+    is_loaded_ = true;
+  }
+
+  void load_object_eager(object_proxy *proxy, object_store &store)
+  {
+    table_statements &stmts = statements(conn());
+    prepare_eager(conn(), stmts);
+
+    statement<detail::eager_row<T>> &select_by_id = stmts.select_eager_by_id;
+    select_by_id.reset();
+    select_by_id.bind(*proxy->pk(), 0);
+
+    detail::eager_object<T> object(eager_parts_);
+    detail::eager_row<T> row(&object);
+    bool found = false;
+    {
+      auto result = select_by_id.execute();
+      found = result.fetch(row);
+    }
+    // release the statement before any
+    // further object is loaded
+    select_by_id.reset();
+
+    if (found) {
+      insert_eager(object, store);
+    }
+  }
+
+  /*
+   * reads all rows of the result into objects with
+   * their joined objects. the objects must not be
+   * inserted before the last row is read, because
+   * inserting may run further statements on the
+   * connection of a streamed result
+   */
+  std::size_t read_eager(result<detail::eager_row<T>> &res, std::vector<detail::eager_object<T>> &objects)
+  {
+    std::size_t rows = 0;
+    while (true) {
+      detail::eager_object<T> object(eager_parts_);
+      detail::eager_row<T> row(&object);
+      if (!res.fetch(row)) {
+        break;
+      }
+      objects.push_back(std::move(object));
+      ++rows;
+    }
+    return rows;
+  }
+
+  object_proxy* insert_eager(detail::eager_object<T> &object, object_store &store)
+  {
+    // the referenced objects are inserted first,
+    // so the object is resolved to them
+    for (std::unique_ptr<detail::basic_eager_value> &value : object.values) {
+      value->insert(*this, store);
+    }
+    return insert_loaded(object.obj.release(), store);
+  }
+
+  void prepare_eager(connection &conn, table_statements &stmts)
+  {
+    if (stmts.eager_version == eager_version_) {
+      return;
+    }
+
+    query<detail::eager_row<T>> q(name());
+    select_eager(q);
+    stmts.select_eager = q.prepare(conn, t_result_mode::STREAMED);
+
+    column id(name() + "." + detail::identifier_column_resolver::resolve<T>().name);
+    select_eager(q);
+    stmts.select_eager_by_id = q.where(id == 1).prepare(conn);
+
+    // the chunk statements are
+    // prepared for the new plan
+    stmts.chunk_size = 0;
+    stmts.eager_version = eager_version_;
+  }
+
+  void select_eager(query<detail::eager_row<T>> &q)
+  {
+    // the columns are qualified with their
+    // table, they may appear in several tables
+    std::vector<std::string> cols;
+    T obj;
+    detail::column_serializer serializer(columns::WITHOUT_BRACKETS);
+    std::unique_ptr<columns> own_cols(serializer.execute(obj));
+    for (const std::shared_ptr<column> &col : own_cols->columns_) {
+      cols.push_back(name() + "." + col->name);
+    }
+    add_eager_columns(eager_parts_, cols);
+
+    q.select(cols);
+    join_eager(eager_parts_, q);
+  }
+
+  static void add_eager_columns(const detail::t_eager_part_vector &parts, std::vector<std::string> &cols)
+  {
+    // in the order the rows are read
+    for (const std::unique_ptr<detail::basic_eager_part> &part : parts) {
+      cols.insert(cols.end(), part->columns().begin(), part->columns().end());
+      add_eager_columns(part->parts(), cols);
+    }
+  }
+
+  static void join_eager(const detail::t_eager_part_vector &parts, query<detail::eager_row<T>> &q)
+  {
+    // a table is joined before the
+    // tables joined to it
+    for (const std::unique_ptr<detail::basic_eager_part> &part : parts) {
+      q.left_join(part->table_name(), part->foreign_column(), part->id_column());
+      join_eager(part->parts(), q);
+    }
+  }
+
+  object_proxy* insert_loaded(T *obj, object_store &store)
+  {
+    // try to find object proxy by id
+    std::shared_ptr<basic_identifier> id(identifier_resolver_.resolve_object(obj));
+
+    detail::t_identifier_map::iterator i = identifier_proxy_map_.find(id);
+    if (i != identifier_proxy_map_.end()) {
+      // use proxy;
+      proxy_.reset(i->second);
+      proxy_->reset(obj, false);
+      identifier_proxy_map_.erase(i);
+    } else if (object_proxy *loaded = node()->find_proxy(id)) {
+      // object was already loaded on demand
+      delete obj;
+      return loaded;
+    } else {
+      // create new proxy
+      proxy_.reset(new object_proxy(obj));
+    }
+
+    object_proxy *proxy = store.insert<T>(proxy_.release(), false);
+    resolver_.resolve(proxy, &store);
+    return proxy;
+  }
+
+  /*
+   * keyset pagination: the first chunk is
+   * selected ordered by the primary key, each
+   * following chunk starts behind the primary
+   * key of the last read object. The read objects
+   * (with their joined objects if fetched eagerly)
+   * are passed to the given function returning
+   * the object holding that primary key.
+   */
+  template < class F >
+  void read_chunked(connection &conn, std::size_t chunk_size, const t_load_progress_func &progress, F take)
+  {
+    table_statements &stmts = statements(conn);
+    prepare_chunk_statements(conn, stmts, chunk_size);
+
+    unsigned long rows = 0;
+    T *last_obj = nullptr;
+    std::size_t chunk_rows = 0;
+    do {
+      if (eager_fields_.empty()) {
+        chunk_rows = read_chunk(stmts, stmts.select_first_chunk, stmts.select_next_chunk, last_obj, take);
+      } else {
+        chunk_rows = read_chunk(stmts, stmts.select_eager_first_chunk, stmts.select_eager_next_chunk, last_obj, take);
+      }
+      rows += chunk_rows;
+
+      if (progress) {
+        progress(name(), rows);
+      }
+    } while (chunk_rows == chunk_size);
+  }
+
+  template < class F >
+  std::size_t read_chunk(table_statements &stmts, statement<T> &first_chunk, statement<T> &next_chunk, T *&last_obj, F take)
+  {
+    statement<T> *stmt = &first_chunk;
+    if (last_obj != nullptr) {
+      stmt = &next_chunk;
+    }
+    stmt->reset();
+    if (last_obj != nullptr) {
+      stmts.binder.bind(last_obj, stmt, 0);
+    }
+
+    // the whole chunk is read before
+    // the objects are taken
+    std::vector<detail::eager_object<T>> objects;
+    {
+      auto result = stmt->execute();
+
+      auto first = result.begin();
+      auto last = result.end();
+
+      while (first != last) {
+        objects.emplace_back();
+        objects.back().obj.reset(first.release());
+        ++first;
+      }
+    }
+    for (detail::eager_object<T> &object : objects) {
+      last_obj = take(object);
+    }
+    return objects.size();
+  }
+
+  template < class F >
+  std::size_t read_chunk(table_statements &, statement<detail::eager_row<T>> &first_chunk, statement<detail::eager_row<T>> &next_chunk, T *&last_obj, F take)
+  {
+    statement<detail::eager_row<T>> *stmt = &first_chunk;
+    if (last_obj != nullptr) {
+      stmt = &next_chunk;
+    }
+    stmt->reset();
+    if (last_obj != nullptr) {
+      std::shared_ptr<basic_identifier> id(identifier_resolver_.resolve_object(last_obj));
+      stmt->bind(*id, 0);
+    }
+
+    std::vector<detail::eager_object<T>> objects;
+    {
+      auto result = stmt->execute();
+      read_eager(result, objects);
+    }
+    for (detail::eager_object<T> &object : objects) {
+      last_obj = take(object);
+    }
+    return objects.size();
+  }
+
+  void update_all(table_statements &stmts, T *obj)
+  {
+    size_t pos = stmts.update.bind(obj, 0);
+    stmts.binder.bind(obj, &stmts.update, pos);
+    // Todo: check result
+    stmts.update.execute();
+  }
+
+  statement<T>& prepare_update(connection &conn, table_statements &stmts, T *obj, const detail::field_snapshot::t_field_mask &fields)
+  {
+    // one update statement for each
+    // set of modified columns
+    auto i = stmts.update_fields.find(fields);
+    if (i == stmts.update_fields.end()) {
+      query<T> q(name());
+      column id = detail::identifier_column_resolver::resolve<T>();
+      i = stmts.update_fields.insert(std::make_pair(fields, q.update(*obj, fields).where(id == 1).prepare(conn))).first;
+    }
+    return i->second;
+  }
+
+  void insert_parameter_sets(table_statements &stmts, const std::vector<object_proxy*> &proxies)
+  {
+    std::size_t max_sets = stmts.insert.max_parameter_sets();
+    auto first = proxies.begin();
+    while (first != proxies.end()) {
+      std::size_t sets = std::min<std::size_t>(proxies.end() - first, max_sets);
+      for (std::size_t set = 0; set < sets; ++set) {
+        stmts.insert.bind_set((T*)first[set]->obj(), set);
+      }
+      // Todo: check result
+      stmts.insert.execute();
+      first += sets;
+    }
+  }
+
+  void prepare_insert_batch(connection &conn, table_statements &stmts, std::size_t rows)
+  {
+    // the count of value lists is part of the
+    // statement, so prepare again if it changes
+    if (rows == stmts.insert_batch_rows) {
+      return;
+    }
+    query<T> q(name());
+    stmts.insert_batch = q.insert(rows).prepare(conn);
+    stmts.insert_batch_rows = rows;
+  }
+
+  void prepare_chunk_statements(connection &conn, table_statements &stmts, std::size_t chunk_size)
+  {
+    // a new eager plan resets the chunk size
+    prepare_eager(conn, stmts);
+    // the limit is part of the statement, so
+    // prepare again if the chunk size changes
+    if (chunk_size == stmts.chunk_size) {
+      return;
+    }
+    query<T> q(name());
+    column id = detail::identifier_column_resolver::resolve<T>();
+    stmts.select_first_chunk = q.select().order_by(id.name).asc().limit(chunk_size).prepare(conn, t_result_mode::STREAMED);
+    stmts.select_next_chunk = q.select().where(id > 1).order_by(id.name).asc().limit(chunk_size).prepare(conn, t_result_mode::STREAMED);
+    if (!eager_fields_.empty()) {
+      query<detail::eager_row<T>> eq(name());
+      column eager_id(name() + "." + id.name);
+      select_eager(eq);
+      stmts.select_eager_first_chunk = eq.order_by(eager_id.name).asc().limit(chunk_size).prepare(conn, t_result_mode::STREAMED);
+      select_eager(eq);
+      stmts.select_eager_next_chunk = eq.where(eager_id > 1).order_by(eager_id.name).asc().limit(chunk_size).prepare(conn, t_result_mode::STREAMED);
+    }
+    stmts.chunk_size = chunk_size;
+  }
 
-  statement<T> insert_;
-  statement<T> update_;
-  statement<T> delete_;
-  statement<T> select_;
+  static std::size_t count_columns()
+  {
+    T obj;
+    detail::column_serializer serializer(columns::WITHOUT_BRACKETS);
+    std::unique_ptr<columns> cols(serializer.execute(obj));
+    return cols->columns_.size();
+  }
 
+private:
   detail::relation_resolver<T> resolver_;
   detail::relation_item_appender<T> appender_;
 
   std::unique_ptr<object_proxy> proxy_;
 
+  // objects read by fetch() waiting to be merged
+  std::vector<detail::eager_object<T>> fetched_;
+
   identifier_resolver<T> identifier_resolver_;
+
+  std::size_t column_count_;
+
+  // the has one fields fetched eagerly and
+  // the plan built of them on first use
+  std::vector<std::string> eager_fields_;
+  detail::t_eager_part_vector eager_parts_;
+  std::size_t eager_version_ = 0;
 };
 
 }
@@ -116,11 +116,23 @@ public:
   /**
    * @brief Build a sql statement as a prepared statement
    *
+   * The compiled statement string and its bind and
+   * column counts are cached by the structural key
+   * of the sql object. Another sql object with the
+   * same structure isn't compiled and linked again.
+   *
    * @param s The sql object to be compiled and linked
    * @return The sql string as a prepared statement
    */
   std::string prepare(const sql &s);
 
+  /**
+   * @brief The count of cached prepared statements
+   *
+   * @return Count of cached prepared statement strings
+   */
+  size_t cached_statement_count() const;
+
   /**
    * @brief The count of values to be bind
    *
@@ -190,6 +202,18 @@ private:
 
   std::stack<detail::build_info> build_info_stack_;
 
+  struct compiled_statement
+  {
+    std::string sql;
+    size_t bind_count;
+    size_t column_count;
+  };
+
+  typedef std::unordered_map<std::string, compiled_statement> t_compiled_statement_map;
+  t_compiled_statement_map compiled_statements_;
+
+  static const size_t max_compiled_statements = 1024;
+
   typedef std::unordered_map<detail::token::t_token, std::string, std::hash<int>> t_token_map;
   t_token_map tokens {
     {detail::token::CREATE_TABLE, "CREATE TABLE"},
@@ -202,6 +226,7 @@ private:
     {detail::token::COLUMNS, "COLUMNS"},
     {detail::token::COLUMN, "COLUMN"},
     {detail::token::FROM, "FROM"},
+    {detail::token::LEFT_JOIN, "LEFT JOIN"},
     {detail::token::WHERE, "WHERE"},
     {detail::token::AND, "AND"},
     {detail::token::OR, "OR"},
@@ -54,6 +54,7 @@ public:
   virtual void visit(const oos::detail::identifier_varchar_column &varchar_column) override;
   virtual void visit(const oos::detail::basic_value_column &value_column) override;
   virtual void visit(const oos::detail::from &from1) override;
+  virtual void visit(const oos::detail::left_join &join1) override;
   virtual void visit(const oos::detail::where &where1) override;
   virtual void visit(const oos::detail::basic_condition &condition) override;
   virtual void visit(const oos::detail::basic_column_condition &condition) override;
@@ -61,6 +61,7 @@ public:
   virtual void visit(const oos::detail::group_by &) override;
   virtual void visit(const oos::detail::insert &) override;
   virtual void visit(const oos::detail::from &) override;
+  virtual void visit(const oos::detail::left_join &) override;
   virtual void visit(const oos::detail::where &) override;
   virtual void visit(const oos::detail::basic_condition &) override;
   virtual void visit(const oos::detail::basic_column_condition &) override;
@@ -82,6 +83,7 @@ protected:
   build_info& top() const;
 
   void append_to_result(basic_dialect &dialect, const std::string &part);
+  bool is_direct(const basic_dialect &dialect) const;
 
 private:
   friend class oos::basic_dialect;
@@ -112,6 +112,7 @@ protected:
     QUERY_COLUMN,
     QUERY_SET,
     QUERY_FROM,
+    QUERY_JOIN,
     QUERY_WHERE,
     QUERY_COND_WHERE,
     QUERY_ORDERBY,
@@ -80,6 +80,18 @@ public:
 
   virtual std::string evaluate(basic_dialect::t_compile_type compiler_type) const = 0;
 
+  /**
+   * Appends the structure of the condition to the
+   * given key. Conditions with the same structure
+   * evaluate to the same prepared string.
+   *
+   * @param key The key to append the structure to
+   */
+  virtual void append_key(std::string &key) const
+  {
+    key += evaluate(basic_dialect::PREPARED);
+  }
+
   static std::array<std::string, num_operands> operands;
 };
 
@@ -93,6 +105,14 @@ public:
     : field_(fld), operand(detail::basic_condition::operands[op])
   { }
 
+  virtual void append_key(std::string &key) const override
+  {
+    key += field_.name;
+    key += ' ';
+    key += operand;
+    key += " ?";
+  }
+
   virtual void accept(token_visitor &visitor) override
   {
     visitor.visit(*this);
@@ -201,6 +221,11 @@ public:
     , value(val)
   { }
 
+  void append_key(std::string &key) const override
+  {
+    key += evaluate(basic_dialect::PREPARED);
+  }
+
   T value;
 
   std::string evaluate(basic_dialect::t_compile_type) const
@@ -222,6 +247,11 @@ public:
     , value(val)
   { }
 
+  void append_key(std::string &key) const override
+  {
+    key += evaluate(basic_dialect::PREPARED);
+  }
+
   T value;
 
   std::string evaluate(basic_dialect::t_compile_type) const
@@ -262,6 +292,20 @@ public:
     , args_(args)
   {}
 
+  /**
+   * @brief Creates an IN condition
+   *
+   * Creates an IN condition for the given column and
+   * the given vector of arguments.
+   *
+   * @param col Column for the IN condition
+   * @param args Vector of arguments
+   */
+  condition(const column &col, const std::vector<V> &args)
+    : basic_in_condition(col)
+    , args_(args)
+  {}
+
   /**
    * @brief Evaluates the condition
    *
@@ -307,6 +351,18 @@ public:
     return args_.size();
   }
 
+  /**
+   * @brief Appends the structure of the condition to the key
+   *
+   * @param key The key to append the structure to
+   */
+  virtual void append_key(std::string &key) const override
+  {
+    key += field_.name;
+    key += " IN ";
+    key += std::to_string(args_.size());
+  }
+
 private:
   std::vector<V> args_;
 };
@@ -384,6 +440,17 @@ public:
   condition(const column &col, const std::pair<T, T> &range)
     : field_(col), range_(range) { }
 
+  /**
+   * @brief Appends the structure of the condition to the key
+   *
+   * @param key The key to append the structure to
+   */
+  void append_key(std::string &key) const override
+  {
+    key += field_.name;
+    key += " BETWEEN";
+  }
+
   /**
    * @brief Evaluates the condition
    *
@@ -434,6 +501,22 @@ public:
   condition(const condition<L1, R1> &l, const condition<L2, R2> &r, detail::basic_condition::t_operand op)
     : left(l), right(r), operand(op) { }
 
+  /**
+   * @brief Appends the structure of the condition to the key
+   *
+   * @param key The key to append the structure to
+   */
+  void append_key(std::string &key) const override
+  {
+    key += '(';
+    left.append_key(key);
+    key += ' ';
+    key += detail::basic_condition::operands[operand];
+    key += ' ';
+    right.append_key(key);
+    key += ')';
+  }
+
   /**
    * @brief Evaluates the condition
    *
@@ -476,6 +559,19 @@ public:
   condition(const condition<L, R> &c)
     : cond(c), operand(detail::basic_condition::operands[detail::basic_condition::NOT]) { }
 
+  /**
+   * @brief Appends the structure of the condition to the key
+   *
+   * @param key The key to append the structure to
+   */
+  void append_key(std::string &key) const override
+  {
+    key += operand;
+    key += " (";
+    cond.append_key(key);
+    key += ')';
+  }
+
   /**
    * @brief Evaluates the condition
    *
@@ -524,6 +620,23 @@ condition<column, std::initializer_list<V>> in(const oos::column &col, std::init
   return condition<column, std::initializer_list<V>>(col, args);
 }
 
+/**
+ * @brief Creates an IN condition for a given column and a vector of values
+ *
+ * In contrast to the initializer list the count of
+ * values may be determined at runtime.
+ *
+ * @tparam V The type of the vector arguments
+ * @param col The column to compare
+ * @param args The vector of values
+ * @return The condition object
+ */
+template < class V >
+condition<column, std::initializer_list<V>> in(const oos::column &col, const std::vector<V> &args)
+{
+  return condition<column, std::initializer_list<V>>(col, args);
+}
+
 /**
  * @brief Creates an IN condition for a given column and a query to be executed
  *
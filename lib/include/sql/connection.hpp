@@ -22,11 +22,36 @@
 #include "field.hpp"
 
 #include <string>
+#include <memory>
+#include <unordered_map>
 
 namespace oos {
 
 class basic_dialect;
 
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Base class of the statement caches of a connection
+ *
+ * Components preparing their statements lazily
+ * (i.e. a table) keep them in a cache derived
+ * from this class. The connection holds the caches
+ * under a key chosen by the component and drops
+ * them when it is closed.
+ */
+class OOS_API basic_statement_cache
+{
+public:
+  virtual ~basic_statement_cache() {}
+};
+
+/// @endcond
+
+}
+
 /**
  * @brief The connection class represents a connection to a database.
  */
@@ -158,6 +183,70 @@ public:
    */
   bool is_valid() const;
 
+  /**
+   * @brief Returns the statement cache stored under the given key
+   *
+   * @param key The key of the cache
+   * @return The statement cache or nullptr if there is none
+   */
+  detail::basic_statement_cache* statement_cache(unsigned long key) const;
+
+  /**
+   * @brief Stores a statement cache under the given key
+   *
+   * An existing cache with the same key is replaced.
+   * The cache is dropped when the connection is closed.
+   *
+   * @param key The key of the cache
+   * @param cache The statement cache to store
+   * @return The stored statement cache
+   */
+  detail::basic_statement_cache* statement_cache(unsigned long key, std::unique_ptr<detail::basic_statement_cache> cache);
+
+  /**
+   * @brief Sets the capacity of the prepared statement cache
+   *
+   * Prepared statements are kept after use in a
+   * least recently used cache keyed by their sql
+   * string. Preparing the same sql string again
+   * reuses the cached backend statement. A capacity
+   * of zero disables the cache.
+   *
+   * @param capacity The maximum count of cached statements
+   */
+  void statement_cache_capacity(std::size_t capacity);
+
+  /**
+   * Returns the capacity of the prepared statement cache
+   *
+   * @return The capacity of the prepared statement cache
+   */
+  std::size_t statement_cache_capacity() const;
+
+  /**
+   * Returns the count of prepared statements
+   * taken from the cache since the connection
+   * was opened
+   *
+   * @return The count of cache hits
+   */
+  std::size_t statement_cache_hits() const;
+
+  /**
+   * Returns the count of statements prepared
+   * by the backend since the connection was opened
+   *
+   * @return The count of cache misses
+   */
+  std::size_t statement_cache_misses() const;
+
+  /**
+   * Returns the count of idle cached prepared statements
+   *
+   * @return The count of cached prepared statements
+   */
+  std::size_t cached_statement_count() const;
+
 private:
   template < class T >
   friend class query;
@@ -188,16 +277,19 @@ private:
   template < class T >
   statement<T> prepare(const oos::sql &sql, typename std::enable_if< !std::is_same<T, row>::value >::type* = 0)
   {
-    return statement<T>(impl_->prepare(sql));
+    return statement<T>(acquire_statement(sql), prepared_statements_);
   }
 
   template < class T >
   statement<T> prepare(const oos::sql &sql, const std::string &tablename, row prototype, typename std::enable_if< std::is_same<T, row>::value >::type* = 0)
   {
     prepare_prototype_row(prototype, tablename);
-    return statement<T>(impl_->prepare(sql), prototype);
+    return statement<T>(acquire_statement(sql), prepared_statements_, prototype);
   }
 
+  detail::statement_impl* acquire_statement(const oos::sql &sql);
+  void reset_prepared_statements();
+
 private:
   connection_impl* create_connection(const std::string &type) const;
   void init_from_foreign_connection(const connection &foreign_connection);
@@ -207,6 +299,15 @@ private:
   std::string type_;
   std::string dns_;
   std::unique_ptr<connection_impl> impl_;
+
+  typedef std::unordered_map<unsigned long, std::unique_ptr<detail::basic_statement_cache>> t_statement_cache_map;
+  t_statement_cache_map statement_caches_;
+
+  static const std::size_t default_statement_cache_capacity = 64;
+
+  // statements borrowed from a replaced cache
+  // are deleted instead of being returned
+  std::shared_ptr<detail::prepared_statement_cache> prepared_statements_;
 };
 
 }
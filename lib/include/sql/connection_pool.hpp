@@ -0,0 +1,232 @@
+#ifndef OOS_CONNECTION_POOL_HPP
+#define OOS_CONNECTION_POOL_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "sql/connection.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @brief A pool of connections to one database
+ *
+ * The pool opens up to a maximum count of connections
+ * to the database of the given connection string on
+ * demand. A connection is checked out with acquire()
+ * and returned once the pooled_connection handle is
+ * released or destroyed. If all connections are checked
+ * out acquire() waits until one is returned.
+ *
+ * Each pooled connection keeps the statements prepared
+ * on it (i.e. the statements of the tables), so a
+ * returned connection is handed out again with its
+ * statements already prepared.
+ *
+ * Before a connection is handed out it is checked. A
+ * closed connection or one failing the health check
+ * is reopened (and loses its prepared statements).
+ *
+ * @code
+ * oos::connection_pool pool("sqlite://test.sqlite", 4);
+ *
+ * oos::connection_pool::pooled_connection conn = pool.acquire();
+ * conn->execute("...");
+ * @endcode
+ *
+ * All connections must be returned before the pool
+ * is destroyed.
+ */
+class OOS_API connection_pool
+{
+public:
+  typedef std::function<bool(connection&)> t_health_check; /**< Shortcut to the health check function */
+
+  /**
+   * @brief Handle of a checked out connection
+   *
+   * The handle returns the connection to
+   * the pool when it is destroyed.
+   */
+  class OOS_API pooled_connection
+  {
+  public:
+    /**
+     * Creates an empty handle
+     */
+    pooled_connection();
+    pooled_connection(pooled_connection &&x);
+    pooled_connection& operator=(pooled_connection &&x);
+    pooled_connection(const pooled_connection&) = delete;
+    pooled_connection& operator=(const pooled_connection&) = delete;
+
+    /**
+     * Returns the connection to its pool
+     */
+    ~pooled_connection();
+
+    /**
+     * @brief Returns the connection to its pool
+     *
+     * Afterwards the handle is empty.
+     */
+    void release();
+
+    /**
+     * Returns true if the handle holds a connection
+     *
+     * @return True if the handle holds a connection
+     */
+    bool valid() const;
+
+    /**
+     * Returns the held connection
+     *
+     * @return The held connection
+     */
+    connection& operator*() const;
+
+    /**
+     * Returns the held connection
+     *
+     * @return The held connection
+     */
+    connection* operator->() const;
+
+    /**
+     * Returns the held connection
+     *
+     * @return The held connection or nullptr
+     */
+    connection* get() const;
+
+  private:
+    friend class connection_pool;
+
+    pooled_connection(connection_pool *pool, connection *conn);
+
+  private:
+    connection_pool *pool_ = nullptr;
+    connection *connection_ = nullptr;
+  };
+
+public:
+  /**
+   * @brief Creates a connection pool
+   *
+   * Creates a pool of at most max_size connections
+   * to the database of the given connection string.
+   * No connection is opened until it is acquired.
+   *
+   * @param dns The database connection string
+   * @param max_size The maximum count of connections
+   */
+  connection_pool(const std::string &dns, std::size_t max_size);
+
+  /**
+   * Closes all connections
+   */
+  ~connection_pool();
+
+  connection_pool(const connection_pool&) = delete;
+  connection_pool& operator=(const connection_pool&) = delete;
+
+  /**
+   * @brief Checks out a connection
+   *
+   * Returns an idle connection or opens a new one
+   * if the pool isn't exhausted. Otherwise waits
+   * until a connection is returned.
+   *
+   * @return The checked out connection
+   */
+  pooled_connection acquire();
+
+  /**
+   * @brief Checks out a connection waiting at most the given time
+   *
+   * If no connection gets available within the given
+   * time an empty handle is returned.
+   *
+   * @param timeout The maximum time to wait
+   * @return The checked out connection or an empty handle
+   */
+  pooled_connection acquire(const std::chrono::milliseconds &timeout);
+
+  /**
+   * @brief Sets the health check
+   *
+   * The health check is called with each idle
+   * connection before it is handed out again. If it
+   * returns false or throws the connection is reopened.
+   * By default only open connections are handed out.
+   *
+   * @param check The health check function
+   */
+  void health_check(const t_health_check &check);
+
+  /**
+   * Returns the maximum count of connections
+   *
+   * @return The maximum count of connections
+   */
+  std::size_t max_size() const;
+
+  /**
+   * Returns the count of opened connections
+   *
+   * @return The count of opened connections
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns the count of idle connections
+   *
+   * @return The count of idle connections
+   */
+  std::size_t idle() const;
+
+private:
+  connection* checkout(std::unique_lock<std::mutex> &lock);
+  bool is_healthy(connection &conn, const t_health_check &check) const;
+  void discard(connection *conn);
+  void release(connection *conn);
+
+private:
+  std::string dns_;
+  std::size_t max_size_;
+
+  // count of opened connections including
+  // the ones currently being opened
+  std::size_t size_ = 0;
+
+  std::vector<std::unique_ptr<connection>> connections_;
+  std::vector<connection*> idle_connections_;
+
+  t_health_check health_check_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable available_;
+};
+
+}
+
+#endif //OOS_CONNECTION_POOL_HPP
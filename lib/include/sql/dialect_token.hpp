@@ -132,6 +132,7 @@ struct OOS_API values : public token
   }
 
   std::vector<std::shared_ptr<basic_value>> values_;
+  std::size_t rows_ = 1;
 };
 
 struct OOS_API asc : public token
@@ -157,6 +158,17 @@ struct OOS_API from : public token
   std::string table;
 };
 
+struct OOS_API left_join : public token
+{
+  left_join(const std::string &t, const std::string &l, const std::string &r);
+
+  virtual void accept(token_visitor &visitor) override;
+
+  std::string table;
+  std::string left_column;
+  std::string right_column;
+};
+
 struct OOS_API top : public token
 {
   top(size_t lmt);
@@ -0,0 +1,80 @@
+#ifndef OOS_FIELD_MASK_SERIALIZER_HPP
+#define OOS_FIELD_MASK_SERIALIZER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "tools/access.hpp"
+#include "tools/serializer.hpp"
+
+#include <vector>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Passes only the masked fields of an object
+ *
+ * All fields of an object are counted in serialization
+ * order. A field is passed to the underlying serializer
+ * only if it is marked in the given field mask.
+ */
+class OOS_API field_mask_serializer : public serializer
+{
+public:
+  field_mask_serializer(serializer &s, const std::vector<bool> &mask);
+
+  template < class T >
+  void serialize(T &x)
+  {
+    index_ = 0;
+    oos::access::serialize(static_cast<serializer&>(*this), x);
+  }
+
+  void serialize(const char *id, char &x) override;
+  void serialize(const char *id, short &x) override;
+  void serialize(const char *id, int &x) override;
+  void serialize(const char *id, long &x) override;
+  void serialize(const char *id, unsigned char &x) override;
+  void serialize(const char *id, unsigned short &x) override;
+  void serialize(const char *id, unsigned int &x) override;
+  void serialize(const char *id, unsigned long &x) override;
+  void serialize(const char *id, bool &x) override;
+  void serialize(const char *id, float &x) override;
+  void serialize(const char *id, double &x) override;
+  void serialize(const char *id, char *x, size_t s) override;
+  void serialize(const char *id, std::string &x) override;
+  void serialize(const char *id, varchar_base &x) override;
+  void serialize(const char *id, time &x) override;
+  void serialize(const char *id, date &x) override;
+  void serialize(const char *id, basic_identifier &x) override;
+  void serialize(const char *id, identifiable_holder &x, cascade_type cascade) override;
+
+private:
+  bool next();
+
+private:
+  serializer &serializer_;
+  const std::vector<bool> &mask_;
+  std::size_t index_ = 0;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_FIELD_MASK_SERIALIZER_HPP
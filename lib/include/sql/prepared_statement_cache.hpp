@@ -0,0 +1,140 @@
+#ifndef OOS_PREPARED_STATEMENT_CACHE_HPP
+#define OOS_PREPARED_STATEMENT_CACHE_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace oos {
+
+namespace detail {
+
+class statement_impl;
+
+/// @cond OOS_DEV
+
+/**
+ * @brief A least recently used cache of prepared statements
+ *
+ * The cache keeps the idle backend statements of
+ * a connection keyed by their sql string. A statement
+ * is borrowed with acquire() and leaves the cache
+ * until it is returned with release(). A returned
+ * statement is reset and becomes the most recently
+ * used one. If the cache exceeds its capacity the
+ * least recently used statement is deleted.
+ */
+class OOS_API prepared_statement_cache
+{
+public:
+  /**
+   * Creates a cache holding at most
+   * capacity idle statements
+   *
+   * @param capacity The capacity of the cache
+   */
+  explicit prepared_statement_cache(std::size_t capacity);
+
+  /**
+   * Deletes all idle statements
+   */
+  ~prepared_statement_cache();
+
+  prepared_statement_cache(const prepared_statement_cache&) = delete;
+  prepared_statement_cache& operator=(const prepared_statement_cache&) = delete;
+
+  /**
+   * @brief Borrows the statement of the given sql string
+   *
+   * Returns the idle statement of the sql string
+   * and counts a hit. If there is none nullptr is
+   * returned and a miss is counted.
+   *
+   * @param sql The sql string of the statement
+   * @return The borrowed statement or nullptr
+   */
+  statement_impl* acquire(const std::string &sql);
+
+  /**
+   * @brief Returns a statement to the cache
+   *
+   * The statement is reset and stored under its
+   * sql string. If there is already an idle statement
+   * with the same sql string or the capacity is zero
+   * the statement is deleted.
+   *
+   * @param stmt The statement to return
+   */
+  void release(statement_impl *stmt);
+
+  /**
+   * @brief Returns a statement to the given cache
+   *
+   * If the cache doesn't exist anymore (i.e. the
+   * connection was closed) the statement is deleted.
+   *
+   * @param cache The cache to return the statement to
+   * @param stmt The statement to return
+   */
+  static void release(const std::weak_ptr<prepared_statement_cache> &cache, statement_impl *stmt);
+
+  /**
+   * Deletes all idle statements
+   */
+  void clear();
+
+  /**
+   * Sets the capacity. Exceeding least
+   * recently used statements are deleted.
+   *
+   * @param capacity The new capacity
+   */
+  void capacity(std::size_t capacity);
+
+  std::size_t capacity() const;
+  std::size_t size() const;
+  std::size_t hits() const;
+  std::size_t misses() const;
+
+private:
+  void shrink(std::size_t capacity);
+
+private:
+  typedef std::pair<std::string, std::unique_ptr<statement_impl>> t_cache_entry;
+  typedef std::list<t_cache_entry> t_cache_list;
+  typedef std::unordered_map<std::string, t_cache_list::iterator> t_cache_map;
+
+  // most recently used first
+  t_cache_list statements_;
+  t_cache_map statement_map_;
+
+  std::size_t capacity_;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+
+  mutable std::mutex mutex_;
+};
+
+/// @endcond
+
+}
+
+}
+
+#endif //OOS_PREPARED_STATEMENT_CACHE_HPP
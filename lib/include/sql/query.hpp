@@ -205,21 +205,44 @@ public:
    */
   query& select(const std::initializer_list<std::string> &column_names)
   {
-    reset(t_query_command::SELECT);
-
-    throw_invalid(QUERY_SELECT, state);
-    sql_.append(new detail::select);
+    return select(column_names.begin(), column_names.end());
+  }
 
-    std::unique_ptr<columns> cols(new columns(columns::WITHOUT_BRACKETS));
-    for (auto &&col : column_names) {
-      cols->push_back(std::make_shared<oos::column>(col));
-    }
+  /**
+   * Creates a select statement for the given columns.
+   * The columns may be qualified with their table
+   * name, i.e. when tables are joined.
+   *
+   * @param column_names A vector of column names to select
+   * @return A reference to the query.
+   */
+  query& select(const std::vector<std::string> &column_names)
+  {
+    return select(column_names.begin(), column_names.end());
+  }
 
-    sql_.append(cols.release());
+  /**
+   * Adds a left join of the given table to a select
+   * statement. The rows are joined where the left
+   * column equals the right column. The columns should
+   * be qualified with their table name.
+   *
+   * @code
+   * q.select(cols).left_join("address", "person.address", "address.id")
+   * @endcode
+   *
+   * @param table The name of the table to join
+   * @param left_column The column of the joining table
+   * @param right_column The column of the joined table
+   * @return A reference to the query.
+   */
+  query& left_join(const std::string &table, const std::string &left_column, const std::string &right_column)
+  {
+    throw_invalid(QUERY_JOIN, state);
 
-    sql_.append(new detail::from(table_name_));
+    sql_.append(new detail::left_join(table, left_column, right_column));
 
-    state = QUERY_FROM;
+    state = QUERY_JOIN;
     return *this;
   }
 
@@ -241,6 +264,34 @@ public:
    * @return A reference to the query.
    */
   query& insert(T &obj)
+  {
+    return insert(obj, 1);
+  }
+
+  /**
+   * Creates an insert statement for the given
+   * count of rows based on the internal object.
+   * The statement contains one value list per
+   * row and makes only sense if the query will
+   * be prepared afterwards.
+   *
+   * @param rows The count of rows to insert at once.
+   * @return A reference to the query.
+   */
+  query& insert(std::size_t rows)
+  {
+    return insert(obj_, rows);
+  }
+
+  /**
+   * Creates an insert statement for the given
+   * count of rows based on the given object.
+   *
+   * @param obj The serializable used for the insert statement.
+   * @param rows The count of rows to insert at once.
+   * @return A reference to the query.
+   */
+  query& insert(T &obj, std::size_t rows)
   {
     reset(t_query_command::INSERT);
 
@@ -255,6 +306,7 @@ public:
     detail::value_serializer vserializer;
 
     std::unique_ptr<detail::values> vals(vserializer.execute(obj));
+    vals->rows_ = rows;
 
     sql_.append(vals.release());
 
@@ -305,6 +357,32 @@ public:
     return *this;
   }
 
+  /**
+   * Creates an update statement only for
+   * the object attributes marked in the
+   * given field mask. The mask holds one
+   * entry for each object attribute in
+   * serialization order.
+   *
+   * @param obj The object to be updated.
+   * @param fields The mask of the attributes to be updated.
+   * @return A reference to the query.
+   */
+  query& update(T &obj, const std::vector<bool> &fields)
+  {
+    update(obj);
+
+    std::vector<std::shared_ptr<oos::column>> cols;
+    cols.swap(update_columns_->columns_);
+    for (std::size_t i = 0; i < cols.size(); ++i) {
+      if (i < fields.size() && fields[i]) {
+        update_columns_->columns_.push_back(cols[i]);
+      }
+    }
+
+    return *this;
+  }
+
   query& update(const std::initializer_list<std::pair<std::string, oos::any>> &colvalues)
   {
     reset(t_query_command::UPDATE);
@@ -509,6 +587,44 @@ public:
     return conn.prepare<T>(sql_);
   }
 
+  /**
+   * Creates and returns a prepared
+   * statement based on the current query
+   * delivering its result in the given mode.
+   *
+   * @param conn The connection.
+   * @param mode The result mode of the statement.
+   * @return The new prepared statement.
+   */
+  statement<T> prepare(connection &conn, t_result_mode mode)
+  {
+    statement<T> stmt(conn.prepare<T>(sql_));
+    stmt.result_mode(mode);
+    return stmt;
+  }
+
+private:
+  template < class I >
+  query& select(I first, I last)
+  {
+    reset(t_query_command::SELECT);
+
+    throw_invalid(QUERY_SELECT, state);
+    sql_.append(new detail::select);
+
+    std::unique_ptr<columns> cols(new columns(columns::WITHOUT_BRACKETS));
+    while (first != last) {
+      cols->push_back(std::make_shared<oos::column>(*first++));
+    }
+
+    sql_.append(cols.release());
+
+    sql_.append(new detail::from(table_name_));
+
+    state = QUERY_FROM;
+    return *this;
+  }
+
 private:
   T obj_;
 };
@@ -859,6 +975,23 @@ public:
     return conn.prepare<row>(sql_, table_name_, row_);
   }
 
+  /**
+   * @brief Prepares the query.
+   *
+   * Prepares the query for the given connection
+   * delivering its result in the given mode.
+   *
+   * @param conn The connection used by the query.
+   * @param mode The result mode of the statement.
+   * @return The prepared statement of the query
+   */
+  statement<row> prepare(connection &conn, t_result_mode mode)
+  {
+    statement<row> stmt(conn.prepare<row>(sql_, table_name_, row_));
+    stmt.result_mode(mode);
+    return stmt;
+  }
+
   /**
  * Adds a limit clause to a select
  * statement.
@@ -191,6 +191,22 @@ public:
     creator_func_ = creator_func;
   }
 
+  /**
+   * Fetches the next row of the result into
+   * the given object. The object is reused
+   * for each row, no object is created while
+   * scanning the result. It must not be mixed
+   * up with the iteration via begin() and end().
+   *
+   * @param obj The object to fetch the row into
+   * @return True if a row was fetched
+   */
+  bool fetch(T &obj)
+  {
+    p->bind(&obj);
+    return p->fetch(&obj);
+  }
+
 private:
   friend class result_iterator<T>;
 
@@ -267,6 +283,32 @@ public:
     return p->result_rows();
   }
 
+  /**
+   * Fetches the next row of the result into
+   * the given row. The row must be created
+   * from the prototype of this result.
+   *
+   * @param r The row to fetch into
+   * @return True if a row was fetched
+   */
+  bool fetch(row &r)
+  {
+    p->bind(&r);
+    return p->fetch(&r);
+  }
+
+  /**
+   * Creates a row from the prototype of
+   * this result. It can be passed to fetch
+   * to scan the result.
+   *
+   * @return A row for this result
+   */
+  row prototype() const
+  {
+    return prototype_;
+  }
+
 private:
   friend class result_iterator<row>;
 
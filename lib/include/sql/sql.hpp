@@ -51,6 +51,7 @@ namespace detail {
 
 class basic_dialect_compiler;
 class basic_dialect_linker;
+class statement_key_builder;
 struct build_info;
 
 }
@@ -80,6 +81,7 @@ private:
   friend struct detail::build_info;
   friend class detail::basic_dialect_compiler;
   friend class detail::basic_dialect_linker;
+  friend class detail::statement_key_builder;
   template < class L, class R, class E >
   friend class condition;
 
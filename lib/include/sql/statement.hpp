@@ -19,10 +19,12 @@
 #define STATEMENT_HPP
 
 #include "sql/statement_impl.hpp"
+#include "sql/prepared_statement_cache.hpp"
 #include "sql/result.hpp"
 
 #include <string>
 #include <functional>
+#include <memory>
 
 namespace oos {
 
@@ -48,25 +50,34 @@ public:
     : p(impl)
   { }
 
+  /**
+   * Creates a statement borrowed from the given
+   * cache. On destruction it is returned to the cache.
+   *
+   * @param impl The borrowed statement implementation
+   * @param cache The cache to return the statement to
+   */
+  statement(detail::statement_impl *impl, const std::weak_ptr<detail::prepared_statement_cache> &cache)
+    : p(impl)
+    , cache_(cache)
+  { }
+
   ~statement()
   {
-    if (p) {
-      delete p;
-    }
+    release();
   }
 
   statement(statement &&x)
   {
     std::swap(p, x.p);
+    std::swap(cache_, x.cache_);
   }
 
   statement& operator=(statement &&x)
   {
-    if (p) {
-      delete p;
-      p = nullptr;
-    }
+    release();
     std::swap(p, x.p);
+    std::swap(cache_, x.cache_);
     return *this;
   }
 
@@ -74,6 +85,8 @@ public:
   {
     if (p) {
       p->clear();
+      // a cleared statement can't be reused
+      cache_.reset();
     }
   }
 
@@ -94,19 +107,69 @@ public:
     return p->bind(o, pos);
   }
 
+  size_t bind(T *o, const std::vector<bool> &fields, size_t pos)
+  {
+    return p->bind(o, fields, pos);
+  }
+
   template < class V >
   size_t bind(V &val, size_t pos)
   {
     return p->bind(val, pos);
   }
 
+  /**
+   * Binds the given object as the parameter set
+   * with the given index. The sets bound since the
+   * first set are executed at once.
+   *
+   * @param o The object to bind
+   * @param set The index of the parameter set
+   */
+  void bind_set(T *o, std::size_t set)
+  {
+    p->bind_set(o, set);
+  }
+
+  /**
+   * Returns the count of parameter sets the
+   * statement can bind and execute at once.
+   *
+   * @return The maximum count of parameter sets
+   */
+  std::size_t max_parameter_sets() const
+  {
+    return p->max_parameter_sets();
+  }
+
   std::string str() const
   {
     return p->str();
   }
 
+  void result_mode(t_result_mode mode)
+  {
+    p->result_mode(mode);
+  }
+
+  t_result_mode result_mode() const
+  {
+    return p->result_mode();
+  }
+
+private:
+  void release()
+  {
+    if (p) {
+      detail::prepared_statement_cache::release(cache_, p);
+      p = nullptr;
+    }
+    cache_.reset();
+  }
+
 private:
   oos::detail::statement_impl *p = nullptr;
+  std::weak_ptr<detail::prepared_statement_cache> cache_;
 };
 
 template <>
@@ -123,25 +186,37 @@ public:
     , prototype_(prototype)
   { }
 
+  /**
+   * Creates a statement borrowed from the given
+   * cache. On destruction it is returned to the cache.
+   *
+   * @param impl The borrowed statement implementation
+   * @param cache The cache to return the statement to
+   * @param prototype The prototype row of the result
+   */
+  statement(detail::statement_impl *impl, const std::weak_ptr<detail::prepared_statement_cache> &cache, const row &prototype)
+    : p(impl)
+    , cache_(cache)
+    , prototype_(prototype)
+  { }
+
   ~statement()
   {
-    if (p) {
-      delete p;
-    }
+    release();
   }
 
   statement(statement &&x)
+    : prototype_(x.prototype_)
   {
     std::swap(p, x.p);
+    std::swap(cache_, x.cache_);
   }
 
   statement& operator=(statement &&x)
   {
-    if (p) {
-      delete p;
-      p = nullptr;
-    }
+    release();
     std::swap(p, x.p);
+    std::swap(cache_, x.cache_);
     return *this;
   }
 
@@ -149,6 +224,8 @@ public:
   {
     if (p) {
       p->clear();
+      // a cleared statement can't be reused
+      cache_.reset();
     }
   }
 
@@ -178,8 +255,29 @@ public:
     return p->str();
   }
 
+  void result_mode(t_result_mode mode)
+  {
+    p->result_mode(mode);
+  }
+
+  t_result_mode result_mode() const
+  {
+    return p->result_mode();
+  }
+
+private:
+  void release()
+  {
+    if (p) {
+      detail::prepared_statement_cache::release(cache_, p);
+      p = nullptr;
+    }
+    cache_.reset();
+  }
+
 private:
   oos::detail::statement_impl *p = nullptr;
+  std::weak_ptr<detail::prepared_statement_cache> cache_;
   const row prototype_;
 };
 
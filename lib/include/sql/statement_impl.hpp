@@ -8,6 +8,7 @@
 #include "tools/varchar.hpp"
 
 #include "sql/result.hpp"
+#include "sql/field_mask_serializer.hpp"
 
 #ifdef _MSC_VER
 #ifdef oos_EXPORTS
@@ -26,6 +27,17 @@ namespace oos {
 
 class sql;
 
+/**
+ * Enumeration of the ways a prepared statement
+ * delivers the rows of its result. While a streamed
+ * result isn't read completely or destroyed, the
+ * connection may not execute another statement.
+ */
+enum struct t_result_mode {
+  BUFFERED, /**< The whole result is transferred before the first row is read */
+  STREAMED  /**< The rows are transferred one by one while they are read */
+};
+
 namespace detail {
 
 /// @cond OOS_DEV
@@ -44,12 +56,29 @@ public:
   template < class T >
   size_t bind(T *o, size_t pos)
   {
-    reset();
+    // only a bind at the first position starts
+    // a new binding, otherwise the object is
+    // bound behind the previous bound values
+    if (pos == 0) {
+      reset();
+    }
     host_index = pos;
     oos::access::serialize(static_cast<serializer&>(*this), *o);
     return host_index;
   }
 
+  template < class T >
+  size_t bind(T *o, const std::vector<bool> &fields, size_t pos)
+  {
+    if (pos == 0) {
+      reset();
+    }
+    host_index = pos;
+    field_mask_serializer masked(*this, fields);
+    masked.serialize(*o);
+    return host_index;
+  }
+
   template < class T >
   size_t bind(T &val, size_t pos)
   {
@@ -58,16 +87,71 @@ public:
     return host_index;
   }
 
+  /**
+   * Binds the given object as the parameter set
+   * with the given index. All bound sets are
+   * executed at once, binding the first set
+   * starts a new binding.
+   *
+   * @param o The object to bind
+   * @param set The index of the parameter set
+   * @throw std::logic_error If the statement can't bind as many sets
+   */
+  template < class T >
+  void bind_set(T *o, std::size_t set)
+  {
+    if (set == 0) {
+      reset();
+    }
+    parameter_set(set);
+    host_index = 0;
+    oos::access::serialize(static_cast<serializer&>(*this), *o);
+  }
+
+  /**
+   * Returns the count of parameter sets the
+   * statement can bind and execute at once.
+   * Backends without parameter arrays return one.
+   *
+   * @return The maximum count of parameter sets
+   */
+  virtual std::size_t max_parameter_sets() const;
+
   std::string str() const;
 
+  /**
+   * Sets the way the rows of the result are
+   * delivered. Backends transferring the rows
+   * one by one anyway ignore the mode.
+   *
+   * @param mode The result mode
+   */
+  void result_mode(t_result_mode mode);
+
+  /**
+   * Returns the result mode.
+   *
+   * @return The result mode
+   */
+  t_result_mode result_mode() const;
+
 protected:
   void str(const std::string &s);
 
+  /**
+   * Called before the parameter set with the
+   * given index is bound.
+   *
+   * @param set The index of the parameter set
+   */
+  virtual void parameter_set(std::size_t set);
+
 protected:
   size_t host_index;
 
 private:
   std::string sql_;
+  t_result_mode result_mode_ = t_result_mode::BUFFERED;
 };
 
 /// @endcond
@@ -0,0 +1,98 @@
+#ifndef OOS_STATEMENT_KEY_BUILDER_HPP
+#define OOS_STATEMENT_KEY_BUILDER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+  #pragma warning(disable: 4355)
+#else
+#define OOS_API
+#endif
+
+#include "sql/token_visitor.hpp"
+
+#include <string>
+
+namespace oos {
+
+class sql;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Builds the structural key of a sql object
+ *
+ * The key consists of all token types and their
+ * names, types and sizes but not of the values to
+ * be bound. Two sql objects with the same key result
+ * in the same prepared statement string.
+ */
+class OOS_API statement_key_builder : public token_visitor
+{
+public:
+  /**
+   * Builds the key of the given sql object.
+   *
+   * @param s The sql object to build the key for
+   * @return The structural key of the sql object
+   */
+  std::string build(const sql &s);
+
+  virtual void visit(const oos::detail::create &) override;
+  virtual void visit(const oos::detail::drop &) override;
+  virtual void visit(const oos::detail::select &) override;
+  virtual void visit(const oos::detail::distinct &) override;
+  virtual void visit(const oos::detail::update &) override;
+  virtual void visit(const oos::detail::tablename &table) override;
+  virtual void visit(const oos::detail::set &) override;
+  virtual void visit(const oos::detail::as &) override;
+  virtual void visit(const oos::detail::top &) override;
+  virtual void visit(const oos::detail::remove &) override;
+  virtual void visit(const oos::detail::values &values) override;
+  virtual void visit(const oos::detail::basic_value &) override;
+  virtual void visit(const oos::detail::order_by &) override;
+  virtual void visit(const oos::detail::asc &) override;
+  virtual void visit(const oos::detail::desc &) override;
+  virtual void visit(const oos::detail::group_by &) override;
+  virtual void visit(const oos::detail::insert &) override;
+  virtual void visit(const oos::detail::from &) override;
+  virtual void visit(const oos::detail::left_join &) override;
+  virtual void visit(const oos::detail::where &) override;
+  virtual void visit(const oos::detail::basic_condition &) override;
+  virtual void visit(const oos::detail::basic_column_condition &) override;
+  virtual void visit(const oos::detail::basic_in_condition &) override;
+  virtual void visit(const oos::columns &) override;
+  virtual void visit(const oos::column &) override;
+  virtual void visit(const oos::detail::typed_column &) override;
+  virtual void visit(const oos::detail::typed_identifier_column &) override;
+  virtual void visit(const oos::detail::typed_varchar_column &) override;
+  virtual void visit(const oos::detail::identifier_varchar_column &) override;
+  virtual void visit(const oos::detail::basic_value_column &) override;
+  virtual void visit(const oos::detail::begin &) override;
+  virtual void visit(const oos::detail::commit &) override;
+  virtual void visit(const oos::detail::rollback &) override;
+  virtual void visit(oos::detail::query &) override;
+
+private:
+  void append(const std::string &part);
+  void append(int tok);
+
+private:
+  std::string key_;
+};
+
+/// @endcond
+
+}
+
+}
+
+#endif //OOS_STATEMENT_KEY_BUILDER_HPP
@@ -62,6 +62,7 @@ struct OOS_API token
     COLUMNS,
     COLUMN,
     FROM,
+    LEFT_JOIN,
     WHERE,
     AND,
     OR,
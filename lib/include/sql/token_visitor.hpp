@@ -43,6 +43,7 @@ struct set;
 struct asc;
 struct desc;
 struct from;
+struct left_join;
 struct where;
 class basic_condition;
 class basic_column_condition;
@@ -82,6 +83,7 @@ public:
   virtual void visit(const oos::detail::identifier_varchar_column &) = 0;
   virtual void visit(const oos::detail::basic_value_column &) = 0;
   virtual void visit(const oos::detail::from &) = 0;
+  virtual void visit(const oos::detail::left_join &) = 0;
   virtual void visit(const oos::detail::where &) = 0;
   virtual void visit(const oos::detail::basic_condition &) = 0;
   virtual void visit(const oos::detail::basic_column_condition &) = 0;
@@ -31,8 +31,7 @@
   #define OOS_API
 #endif
 
-#include <array>
-#include <list>
+#include <vector>
 
 namespace oos {
 
@@ -42,29 +41,27 @@ namespace oos {
  * @brief A buffer for bytes.
  * 
  * This class provide a buffer for bytes. The
- * bytes are added in chunks. Once the current chunk
- * of bytes is full a new empty chunk is added.
- * The bytes are appended and released from the end
- * of the buffer.
+ * bytes are stored in one contiguous block of
+ * memory. The bytes are appended at the end
+ * and released from the current read position.
+ * The read position can be moved to any former
+ * write position, released bytes are kept until
+ * the buffer is cleared.
  * It is used by the object_store to serialize objects.
  */
 class OOS_API byte_buffer
 {
 private:
-  enum { BUF_SIZE = 1 << 14 };
-  typedef std::array<char, BUF_SIZE> t_data_array;
+  typedef std::vector<char> t_data_vector;
 
 public:
   /**
    * The type of the size.
    */
-  typedef t_data_array::size_type size_type;
+  typedef t_data_vector::size_type size_type;
 
   /**
    * @brief Create an empty buffer.
-   * 
-   * Create an empty buffer. One empty chunk is
-   * also created.
    */
   byte_buffer();
   ~byte_buffer();
@@ -82,8 +79,9 @@ public:
   /**
    * @brief Release a number of bytes.
    * 
-   * A number of bytes is released. The released bytes
-   * are removed from the buffer.
+   * A number of bytes is released from the current
+   * read position. The read position is moved behind
+   * the released bytes.
    * 
    * @param bytes The address of the memory where the bytes should go to.
    * @param size The number of bytes released from the buffer.
@@ -91,28 +89,37 @@ public:
   void release(void *bytes, size_type size);
 
   /**
-   * Return the size of the buffer.
+   * Return the size of the buffer, that is the
+   * number of bytes not released yet.
    */
   size_type size() const;
 
+  /**
+   * Returns the current write position. All
+   * following appended bytes start at this
+   * position.
+   *
+   * @return The current write position
+   */
+  size_type position() const;
+
+  /**
+   * Moves the read position to the given
+   * position.
+   *
+   * @param pos The new read position
+   * @throw std::out_of_range if position is behind the end of the buffer
+   */
+  void seek(size_type pos);
+
   /**
    * Clear the buffer.
    */
   void clear();
 
 private:
-  struct buffer_chunk
-  {
-    buffer_chunk() : read_cursor(0), write_cursor(0) {}
-    byte_buffer::size_type available() const { return data.size() - write_cursor; }
-    byte_buffer::size_type used() const { return write_cursor - read_cursor; }
-    byte_buffer::size_type released() const { return read_cursor; }
-    t_data_array data;
-    byte_buffer::size_type read_cursor;
-    byte_buffer::size_type write_cursor;
-  };
-  typedef std::list<buffer_chunk> t_chunk_list;
-  t_chunk_list chunk_list_;
+  t_data_vector data_;
+  size_type read_cursor_ = 0;
 };
 /// @endcond
 
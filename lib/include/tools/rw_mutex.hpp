@@ -0,0 +1,140 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RW_MUTEX_HPP
+#define RW_MUTEX_HPP
+
+#ifdef _MSC_VER
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace oos {
+
+/**
+ * @cond OOS_DEV
+ * @class rw_mutex
+ * @brief A reader/writer mutex
+ *
+ * Readers and writers wait on condition
+ * variables of one internal mutex. A waiting
+ * writer blocks new readers, so readers can't
+ * starve a writer.
+ *
+ * The exclusive lock is recursive. A thread
+ * holding the exclusive lock may also take
+ * the shared lock. The shared lock isn't
+ * recursive and upgrading a shared lock to
+ * an exclusive lock isn't supported. It
+ * would deadlock and is asserted in debug
+ * builds.
+ */
+class OOS_API rw_mutex
+{
+public:
+  rw_mutex();
+  ~rw_mutex();
+
+  rw_mutex(const rw_mutex&) = delete;
+  rw_mutex& operator=(const rw_mutex&) = delete;
+
+  /**
+   * Acquires the exclusive lock.
+   */
+  void lock();
+
+  /**
+   * Releases the exclusive lock.
+   */
+  void unlock();
+
+  /**
+   * Acquires a shared lock.
+   */
+  void lock_shared();
+
+  /**
+   * Releases a shared lock.
+   */
+  void unlock_shared();
+
+private:
+  bool is_owner() const;
+
+private:
+  std::mutex mutex_;
+  std::condition_variable readers_cond_;
+  std::condition_variable writers_cond_;
+
+  unsigned long readers_ = 0;
+  unsigned long waiting_writers_ = 0;
+  bool writer_ = false;
+
+  std::atomic<std::thread::id> owner_;
+  unsigned long depth_ = 0;
+};
+
+/**
+ * @class shared_guard
+ * @brief Holds a shared lock for its lifetime
+ *
+ * @tparam M The type of the shared lockable
+ */
+template < class M >
+class shared_guard
+{
+public:
+  /**
+   * Acquires a shared lock on the given mutex.
+   *
+   * @param m The mutex to lock
+   */
+  explicit shared_guard(M &m)
+    : mutex_(m)
+  {
+    mutex_.lock_shared();
+  }
+
+  ~shared_guard()
+  {
+    mutex_.unlock_shared();
+  }
+
+  shared_guard(const shared_guard&) = delete;
+  shared_guard& operator=(const shared_guard&) = delete;
+
+private:
+  M &mutex_;
+};
+/// @endcond
+
+}
+
+#endif /* RW_MUTEX_HPP */
@@ -0,0 +1,120 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SLAB_ALLOCATOR_HPP
+#define SLAB_ALLOCATOR_HPP
+
+#ifdef _MSC_VER
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @cond OOS_DEV
+ * @class slab_allocator
+ * @brief Allocates blocks of a fixed size
+ *
+ * The allocator hands out blocks of one fixed
+ * size from larger slabs of memory. Blocks
+ * allocated one after another are adjacent in
+ * memory. Freed blocks are kept in a free list
+ * and reused. Once all blocks are freed the
+ * slabs are released.
+ */
+class OOS_API slab_allocator
+{
+public:
+  /**
+   * Creates a slab allocator for blocks
+   * of the given size.
+   *
+   * @param block_size The size of one block
+   * @param blocks_per_slab The number of blocks in one slab
+   */
+  explicit slab_allocator(std::size_t block_size, std::size_t blocks_per_slab = 1024);
+  ~slab_allocator();
+
+  slab_allocator(const slab_allocator&) = delete;
+  slab_allocator& operator=(const slab_allocator&) = delete;
+
+  /**
+   * Allocates one block.
+   *
+   * @return The allocated block
+   */
+  void* allocate();
+
+  /**
+   * Returns the given block to the allocator.
+   *
+   * @param p The block to be freed
+   */
+  void deallocate(void *p);
+
+  /**
+   * Returns the count of allocated blocks.
+   *
+   * @return The count of allocated blocks
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns the count of allocated slabs.
+   *
+   * @return The count of allocated slabs
+   */
+  std::size_t slabs() const;
+
+private:
+  void release_slabs();
+
+private:
+  struct free_block
+  {
+    free_block *next;
+  };
+
+  std::size_t block_size_;
+  std::size_t blocks_per_slab_;
+
+  std::vector<char*> slabs_;
+  free_block *free_list_ = nullptr;
+  char *next_block_ = nullptr;
+  char *slab_end_ = nullptr;
+  std::size_t size_ = 0;
+
+  mutable std::mutex mutex_;
+};
+/// @endcond
+
+}
+
+#endif /* SLAB_ALLOCATOR_HPP */
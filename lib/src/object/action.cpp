@@ -31,6 +31,16 @@ action::~action()
   delete serializer_;
 }
 
+void action::backup_position(std::size_t pos)
+{
+  backup_position_ = pos;
+}
+
+std::size_t action::backup_position() const
+{
+  return backup_position_;
+}
+
 void action::remove_proxy(object_proxy *proxy, object_store *store)
 {
   store->remove_proxy(proxy);
@@ -46,4 +56,12 @@ void action::insert_proxy(object_store *store, object_proxy *proxy)
   store->insert_proxy(proxy);
 }
 
+void action::move_backup(action &from, action &to)
+{
+  // the serializer keeps the state
+  // of the backup (i.e. identifier type)
+  std::swap(from.serializer_, to.serializer_);
+  to.backup_position_ = from.backup_position_;
+}
+
 }
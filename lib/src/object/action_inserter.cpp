@@ -42,4 +42,9 @@ const char* action_inserter::type(object_proxy *proxy) const
   return proxy->node()->type();
 }
 
+const prototype_node* action_inserter::node(object_proxy *proxy) const
+{
+  return proxy->node();
+}
+
 }
\ No newline at end of file
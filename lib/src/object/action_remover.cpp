@@ -40,9 +40,8 @@ void action_remover::visit(insert_action *a)
   if (i != a->end()) {
     a->erase(i);
   }
-  if (a->empty()) {
-    actions_.erase(actions_.begin() + index_);
-  }
+  // an empty insert action is kept, erasing
+  // it would invalidate all following indices
 }
 
 void action_remover::visit(update_action *a)
@@ -57,7 +56,7 @@ void action_remover::visit(update_action *a)
    ***********/
 //  if (a->proxy()->id() == id_) {
   if (a->proxy()->id() == proxy_->id()) {
-    actions_.at(0).reset(a->release_delete_action());
+    actions_.at(index_).reset(a->create_delete_action());
   }
 }
 
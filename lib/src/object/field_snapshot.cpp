@@ -0,0 +1,156 @@
+#include "object/field_snapshot.hpp"
+
+#include "tools/varchar.hpp"
+#include "tools/date.hpp"
+#include "tools/time.hpp"
+#include "tools/basic_identifier.hpp"
+#include "tools/identifiable_holder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace oos {
+
+namespace detail {
+
+field_snapshot::field_snapshot() {}
+
+field_snapshot::~field_snapshot() {}
+
+void field_snapshot::serialize(const char *, char &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, short &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, int &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, long &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, unsigned char &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, unsigned short &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, unsigned int &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, unsigned long &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, bool &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, float &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, double &x)
+{
+  append(&x, sizeof(x));
+}
+
+void field_snapshot::serialize(const char *, char *x, size_t s)
+{
+  append(x, strnlen(x, s));
+}
+
+void field_snapshot::serialize(const char *, std::string &x)
+{
+  append(x.data(), x.size());
+}
+
+void field_snapshot::serialize(const char *, varchar_base &x)
+{
+  append(x.c_str(), x.size());
+}
+
+void field_snapshot::serialize(const char *, time &x)
+{
+  struct timeval tv = x.get_timeval();
+  ++depth_;
+  append(&tv.tv_sec, sizeof(tv.tv_sec));
+  append(&tv.tv_usec, sizeof(tv.tv_usec));
+  --depth_;
+  next_field();
+}
+
+void field_snapshot::serialize(const char *, date &x)
+{
+  int julian_date = x.julian_date();
+  append(&julian_date, sizeof(julian_date));
+}
+
+void field_snapshot::serialize(const char *id, basic_identifier &x)
+{
+  // the identifier value is written
+  // into the image of this field
+  ++depth_;
+  x.serialize(id, *this);
+  --depth_;
+  next_field();
+}
+
+void field_snapshot::serialize(const char *id, identifiable_holder &x, cascade_type)
+{
+  // the image of a relation is the
+  // primary key of the related object
+  if (x.has_primary_key()) {
+    ++depth_;
+    x.primary_key()->serialize(id, *this);
+    --depth_;
+  }
+  next_field();
+}
+
+void field_snapshot::append(const void *data, size_t size)
+{
+  const char *bytes = static_cast<const char*>(data);
+  current_.insert(current_.end(), bytes, bytes + size);
+  if (depth_ == 0) {
+    next_field();
+  }
+}
+
+void field_snapshot::next_field()
+{
+  if (compare_) {
+    bool modified = true;
+    if (index_ < ends_.size()) {
+      std::size_t begin = index_ > 0 ? ends_[index_ - 1] : 0;
+      modified = ends_[index_] - begin != current_.size() ||
+                 !std::equal(current_.begin(), current_.end(), image_.begin() + begin);
+    }
+    modified_.push_back(modified);
+  } else {
+    image_.insert(image_.end(), current_.begin(), current_.end());
+    ends_.push_back(image_.size());
+  }
+  ++index_;
+  current_.clear();
+}
+
+}
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object/object_index.hpp"
+
+namespace oos {
+
+namespace detail {
+
+basic_object_index::basic_object_index(t_index_type type)
+  : type_(type)
+{}
+
+basic_object_index::~basic_object_index()
+{}
+
+void basic_object_index::insert(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  dirty_.insert(proxy);
+}
+
+void basic_object_index::update(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  // only a violation of the given proxy counts here
+  refresh();
+  if (proxy->obj() == nullptr) {
+    dirty_.insert(proxy);
+  } else if (!rekey(proxy)) {
+    dirty_.insert(proxy);
+    throw object_exception("unique index violated");
+  } else {
+    dirty_.erase(proxy);
+  }
+}
+
+void basic_object_index::remove(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  dirty_.erase(proxy);
+  erase(proxy);
+}
+
+void basic_object_index::mark_dirty(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  dirty_.insert(proxy);
+}
+
+t_index_type basic_object_index::type() const
+{
+  return type_;
+}
+
+void basic_object_index::refresh()
+{
+  auto i = dirty_.begin();
+  while (i != dirty_.end()) {
+    // a proxy violating a unique index
+    // stays unkeyed until its value is
+    // unique again
+    if ((*i)->obj() == nullptr || !rekey(*i)) {
+      ++i;
+    } else {
+      i = dirty_.erase(i);
+    }
+  }
+}
+
+}
+
+}
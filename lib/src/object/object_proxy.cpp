@@ -17,16 +17,58 @@
 
 #include "object/object_store.hpp"
 
+#include "tools/slab_allocator.hpp"
+
+#include <cstdint>
+#include <mutex>
+
 using namespace std;
 
 namespace oos {
 
+namespace {
+
+slab_allocator& proxy_allocator()
+{
+  // never destroyed, proxies of static
+  // stores may be deleted on exit
+  static slab_allocator *allocator = new slab_allocator(sizeof(object_proxy), 4096);
+  return *allocator;
+}
+
+std::mutex& holder_mutex(const object_proxy *proxy)
+{
+  // holders of proxies of a concurrent store are
+  // registered under one of these striped mutexes
+  static std::mutex mutexes[64];
+  return mutexes[(reinterpret_cast<std::uintptr_t>(proxy) / sizeof(object_proxy)) % 64];
+}
+
+}
+
 object_proxy::object_proxy() {}
 
 object_proxy::object_proxy(const std::shared_ptr<basic_identifier> &pk)
   : primary_key_(pk)
 {}
 
+void* object_proxy::operator new(std::size_t size)
+{
+  if (size != sizeof(object_proxy)) {
+    return ::operator new(size);
+  }
+  return proxy_allocator().allocate();
+}
+
+void object_proxy::operator delete(void *p, std::size_t size)
+{
+  if (size != sizeof(object_proxy)) {
+    ::operator delete(p);
+  } else {
+    proxy_allocator().deallocate(p);
+  }
+}
+
 //object_proxy::object_proxy(unsigned long i)
 //  : oid(i)
 //{}
@@ -165,12 +207,22 @@ unsigned long object_proxy::reference_count() const
 
 void object_proxy::add(object_holder *ptr)
 {
-  ptr_set_.insert(ptr);
+  if (ostore_ && ostore_->is_concurrent()) {
+    std::lock_guard<std::mutex> lock(holder_mutex(this));
+    ptr_set_.insert(ptr);
+  } else {
+    ptr_set_.insert(ptr);
+  }
 }
 
 bool object_proxy::remove(object_holder *ptr)
 {
-  return ptr_set_.erase(ptr) == 1;
+  if (ostore_ && ostore_->is_concurrent()) {
+    std::lock_guard<std::mutex> lock(holder_mutex(this));
+    return ptr_set_.erase(ptr) == 1;
+  } else {
+    return ptr_set_.erase(ptr) == 1;
+  }
 }
 
 bool object_proxy::valid() const
@@ -197,6 +249,38 @@ std::shared_ptr<basic_identifier> object_proxy::pk() const
   return primary_key_;
 }
 
+void object_proxy::loader(detail::basic_object_loader *loader)
+{
+  loader_ = loader;
+}
+
+void object_proxy::load()
+{
+  if (obj_ != nullptr) {
+    return;
+  }
+  // loading inserts the object into the store, so
+  // threads sharing a concurrent store load one
+  // after another
+  std::unique_lock<object_store> lock;
+  if (ostore_ != nullptr) {
+    lock = std::unique_lock<object_store>(*ostore_);
+  }
+  if (obj_ != nullptr || loader_ == nullptr) {
+    return;
+  }
+  detail::basic_object_loader *loader = loader_;
+  loader_ = nullptr;
+  loader->load_object(this);
+}
+
+void object_proxy::mark_indexes_dirty()
+{
+  if (node_ != nullptr) {
+    node_->mark_indexes_dirty(this);
+  }
+}
+
 transaction object_proxy::current_transaction()
 {
   return ostore_->current_transaction();
@@ -43,10 +43,11 @@ void object_inserter::reset()
 
 }
 
-object_store::object_store()
+object_store::object_store(bool concurrent)
   : first_(new prototype_node)
   , last_(new prototype_node)
   , object_inserter_(*this)
+  , concurrent_(concurrent)
 {
   // empty tree where first points to last and
   // last points to first sentinel
@@ -63,6 +64,7 @@ object_store::~object_store()
 
 void object_store::detach(const char *type)
 {
+  std::lock_guard<object_store> guard(*this);
   prototype_node *node = find_prototype_node(type);
   if (!node) {
     throw object_exception("unknown prototype type");
@@ -72,6 +74,7 @@ void object_store::detach(const char *type)
 
 object_store::iterator object_store::detach(const prototype_iterator &i)
 {
+  std::lock_guard<object_store> guard(*this);
   if (i == end() || i.get() == nullptr) {
     throw object_exception("invalid prototype iterator");
   }
@@ -117,6 +120,7 @@ prototype_iterator object_store::end()
 
 void object_store::clear(bool full)
 {
+  std::lock_guard<object_store> guard(*this);
   if (full) {
     while (first_->next != last_) {
       remove_prototype_node(first_->next, true);
@@ -140,6 +144,7 @@ void object_store::clear(const char *type)
 
 void object_store::clear(const prototype_iterator &node)
 {
+  std::lock_guard<object_store> guard(*this);
   clear(node.get());
 }
 
@@ -231,6 +236,7 @@ object_proxy* object_store::find_proxy(unsigned long id) const
 
 bool object_store::delete_proxy(unsigned long id)
 {
+  std::lock_guard<object_store> guard(*this);
   t_object_proxy_map::iterator i = object_map_.find(id);
   if (i == object_map_.end()) {
     return false;
@@ -244,6 +250,7 @@ bool object_store::delete_proxy(unsigned long id)
 
 object_proxy* object_store::insert_proxy(object_proxy *proxy)
 {
+  std::lock_guard<object_store> guard(*this);
   if (proxy == nullptr) {
     throw object_exception("proxy is null");
   }
@@ -265,6 +272,7 @@ object_proxy* object_store::insert_proxy(object_proxy *proxy)
 
 void object_store::remove_proxy(object_proxy *proxy)
 {
+  std::lock_guard<object_store> guard(*this);
   if (proxy == nullptr) {
     throw object_exception("object proxy is nullptr");
   }
@@ -284,6 +292,7 @@ void object_store::remove_proxy(object_proxy *proxy)
 
 object_proxy* object_store::register_proxy(object_proxy *oproxy)
 {
+  std::lock_guard<object_store> guard(*this);
   if (oproxy->id() != 0) {
     throw_object_exception("object proxy already registerd");
   }
@@ -299,6 +308,7 @@ object_proxy* object_store::register_proxy(object_proxy *oproxy)
 
 sequencer_impl_ptr object_store::exchange_sequencer(const sequencer_impl_ptr &seq)
 {
+  std::lock_guard<object_store> guard(*this);
   return seq_.exchange_sequencer(seq);
 }
 
@@ -339,6 +349,17 @@ prototype_node* object_store::find_prototype_node(const char *type) const {
   }
 }
 
+void object_store::update_type_slot(std::size_t slot, const t_prototype_map &nodes)
+{
+  if (slot == 0) {
+    return;
+  }
+  if (slot >= type_slots_.size()) {
+    type_slots_.resize(slot + 1, nullptr);
+  }
+  type_slots_[slot] = nodes.size() == 1 ? nodes.begin()->second : nullptr;
+}
+
 prototype_node* object_store::remove_prototype_node(prototype_node *node, bool is_root) {
   // remove (and delete) from tree (deletes subsequently all child nodes
   // for each child call remove_prototype(child);
@@ -361,6 +382,7 @@ prototype_node* object_store::remove_prototype_node(prototype_node *node, bool i
   t_typeid_prototype_map::iterator k = typeid_prototype_map_.find(node->type_id());
   if (k != typeid_prototype_map_.end()) {
     k->second.erase(node->type_);
+    update_type_slot(node->type_slot_, k->second);
     if (k->second.empty()) {
       typeid_prototype_map_.erase(k);
     }
@@ -387,24 +409,92 @@ prototype_node *object_store::find_parent(const char *name) const
   return parent_node;
 }
 
+bool object_store::is_concurrent() const
+{
+  return concurrent_;
+}
+
+void object_store::lock()
+{
+  if (concurrent_) {
+    mutex_.lock();
+  }
+}
+
+void object_store::unlock()
+{
+  if (concurrent_) {
+    mutex_.unlock();
+  }
+}
+
+void object_store::lock_shared() const
+{
+  if (concurrent_) {
+    mutex_.lock_shared();
+  }
+}
+
+void object_store::unlock_shared() const
+{
+  if (concurrent_) {
+    mutex_.unlock_shared();
+  }
+}
+
 void object_store::push_transaction(const transaction &tr)
 {
-  transactions_.push(tr);
+  if (!concurrent_) {
+    transactions_.push(tr);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(transactions_mutex_);
+  thread_transactions_[std::this_thread::get_id()].push(tr);
 }
 
 void object_store::pop_transaction()
 {
-  transactions_.pop();
+  if (!concurrent_) {
+    if (!transactions_.empty()) {
+      transactions_.pop();
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> lock(transactions_mutex_);
+  t_transaction_stack_map::iterator i = thread_transactions_.find(std::this_thread::get_id());
+  if (i == thread_transactions_.end()) {
+    return;
+  }
+  i->second.pop();
+  if (i->second.empty()) {
+    // don't keep a stack for each thread ever seen
+    thread_transactions_.erase(i);
+  }
+}
+
+transaction* object_store::top_transaction()
+{
+  if (!concurrent_) {
+    return transactions_.empty() ? nullptr : &transactions_.top();
+  }
+  std::lock_guard<std::mutex> lock(transactions_mutex_);
+  t_transaction_stack_map::iterator i = thread_transactions_.find(std::this_thread::get_id());
+  // empty stacks are erased on pop
+  return i == thread_transactions_.end() ? nullptr : &i->second.top();
 }
 
 transaction object_store::current_transaction()
 {
-  return transactions_.top();
+  transaction *tr = top_transaction();
+  if (tr == nullptr) {
+    throw object_exception("no current transaction");
+  }
+  return *tr;
 }
 
 bool object_store::has_transaction() const
 {
-  return !transactions_.empty();
+  return const_cast<object_store*>(this)->top_transaction() != nullptr;
 }
 
 //transaction& object_store::begin_transaction()
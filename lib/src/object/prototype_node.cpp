@@ -17,18 +17,41 @@
 
 #include "object/prototype_node.hpp"
 #include "object/object_exception.hpp"
+#include "object/object_index.hpp"
 #include "object/object_proxy.hpp"
 
-#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
 namespace oos {
 
+namespace detail {
+
+std::size_t next_type_slot()
+{
+  static std::atomic<std::size_t> slot(0);
+  return ++slot;
+}
+
+}
+
 prototype_node::prototype_node()
   : type_index_(typeid(void))
 {}
 
+prototype_node::prototype_node(object_store *tree, const char *type, const std::type_info &typeinfo, bool abstract)
+  : tree_(tree)
+  , first(new prototype_node)
+  , last(new prototype_node)
+  , type_(type)
+  , abstract_(abstract)
+  , type_index_(typeinfo)
+{
+  first->next = last.get();
+  last->prev = first.get();
+}
+
 prototype_node::~prototype_node()
 {}
 
@@ -157,6 +180,13 @@ void prototype_node::insert(object_proxy *proxy)
   if (pk) {
     id_map_.insert(std::make_pair(pk, proxy));
   }
+  // the object may not be complete yet,
+  // it is keyed on the next index lookup
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->insert(proxy);
+    }
+  }
 }
 
 void prototype_node::remove(object_proxy *proxy)
@@ -185,6 +215,12 @@ void prototype_node::remove(object_proxy *proxy)
     }
   }
 
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->remove(proxy);
+    }
+  }
+
   // adjust serializable count for node
   --count;
 }
@@ -199,6 +235,11 @@ void prototype_node::clear(bool recursive)
       object_proxy *op = op_first->next_;
       // remove serializable proxy from list
       op->unlink();
+      for (prototype_node *node = this; node != nullptr; node = node->parent) {
+        for (auto &index : node->indexes_) {
+          index->remove(op);
+        }
+      }
       // delete serializable proxy and serializable
       delete op;
     }
@@ -216,6 +257,33 @@ void prototype_node::clear(bool recursive)
   }
 }
 
+void prototype_node::add_index(detail::basic_object_index *index)
+{
+  std::unique_ptr<detail::basic_object_index> idx(index);
+  for (object_proxy *proxy = op_first->next_; proxy != op_last; proxy = proxy->next_) {
+    idx->update(proxy);
+  }
+  indexes_.push_back(std::move(idx));
+}
+
+void prototype_node::update_indexes(object_proxy *proxy)
+{
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->update(proxy);
+    }
+  }
+}
+
+void prototype_node::mark_indexes_dirty(object_proxy *proxy)
+{
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->mark_dirty(proxy);
+    }
+  }
+}
+
 void prototype_node::unlink()
 {
   // unlink node
@@ -376,11 +444,35 @@ void prototype_node::prepare_foreign_key(prototype_node *master_node, const char
 
 object_proxy *prototype_node::find_proxy(const std::shared_ptr<basic_identifier> &pk)
 {
-  detail::t_identifier_map::iterator i = std::find_if(id_map_.begin(), id_map_.end(), [pk](const detail::t_identifier_map::value_type &x) {
-    return *pk == *(x.first);
-  });
-//  t_primary_key_map::iterator i = primary_key_map.find(pk);
-  return (i != id_map_.end() ? i->second : nullptr);
+  if (!pk) {
+    return nullptr;
+  }
+  /*
+   * first look into the identifier
+   * map of this node
+   */
+  detail::t_identifier_map::iterator i = id_map_.find(pk);
+  if (i != id_map_.end()) {
+    return i->second;
+  }
+  /*
+   * proxies of derived types are held
+   * by the child nodes, so look into
+   * the identifier map of each node
+   * of the subtree
+   */
+  if (!has_children()) {
+    return nullptr;
+  }
+  prototype_node *node = first->next;
+  while (node != last.get()) {
+    i = node->id_map_.find(pk);
+    if (i != node->id_map_.end()) {
+      return i->second;
+    }
+    node = node->next_node(this);
+  }
+  return nullptr;
 }
 
 /*
@@ -7,6 +7,26 @@
 
 namespace oos {
 
+namespace {
+
+/*
+ * Marks the objects of all update actions
+ * as dirty, to re-key them with their
+ * committed values on the next index lookup
+ */
+class index_marker : public action_visitor
+{
+public:
+  virtual void visit(insert_action *) {}
+  virtual void visit(update_action *a)
+  {
+    a->proxy()->mark_indexes_dirty();
+  }
+  virtual void visit(delete_action *) {}
+};
+
+}
+
 sequencer transaction::sequencer_ = sequencer();
 
 void transaction::null_observer::on_commit(transaction::t_action_vector &actions)
@@ -58,6 +78,10 @@ void transaction::commit()
   commiting_ = true;
   transaction_data_->observer_->on_commit(transaction_data_->actions_);
   commiting_ = false;
+  index_marker marker;
+  for (action_ptr &actptr : transaction_data_->actions_) {
+    actptr->accept(&marker);
+  }
   cleanup();
 }
 
@@ -76,11 +100,13 @@ void transaction::rollback()
      * clear insert action map
      *
      **************/
-    while (!transaction_data_->actions_.empty()) {
-      action_iterator i = transaction_data_->actions_.begin();
-      action_ptr a = *i;
-      transaction_data_->actions_.erase(i);
-      restore(a);
+    // restore in reverse order, each action
+    // reads its backup from its own position
+    std::lock_guard<object_store> guard(transaction_data_->store_.get());
+    t_action_vector actions;
+    actions.swap(transaction_data_->actions_);
+    for (t_action_vector::reverse_iterator i = actions.rbegin(); i != actions.rend(); ++i) {
+      restore(*i);
     }
 
     if (commiting_) {
@@ -95,6 +121,7 @@ void transaction::rollback()
 
 void transaction::backup(const action_ptr &a, const oos::object_proxy *proxy)
 {
+  a->backup_position(transaction_data_->object_buffer_.position());
   a->backup(transaction_data_->object_buffer_);
   transaction_data_->actions_.push_back(a);
   transaction_data_->id_action_index_map_.insert(std::make_pair(proxy->id(), transaction_data_->actions_.size() - 1));
@@ -102,6 +129,7 @@ void transaction::backup(const action_ptr &a, const oos::object_proxy *proxy)
 
 void transaction::restore(const action_ptr &a)
 {
+  transaction_data_->object_buffer_.seek(a->backup_position());
   a->restore(transaction_data_->object_buffer_, &transaction_data_->store_.get());
 }
 
@@ -32,9 +32,23 @@ void update_action::restore(byte_buffer &buffer, object_store *store)
   restore_func_(buffer, this, store, *serializer_);
 }
 
-delete_action *update_action::release_delete_action()
+delete_action *update_action::create_delete_action()
 {
-  return delete_action_.release();
+  // the delete action restores the object
+  // from the backup of this update action
+  delete_action *act = delete_func_(this);
+  action::move_backup(*this, *act);
+  return act;
+}
+
+bool update_action::has_snapshot() const
+{
+  return has_snapshot_;
+}
+
+detail::field_snapshot& update_action::snapshot()
+{
+  return snapshot_;
 }
 
 }
\ No newline at end of file
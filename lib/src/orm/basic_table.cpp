@@ -5,11 +5,26 @@
 #include <orm/persistence.hpp>
 #include "orm/basic_table.hpp"
 
+#include <atomic>
+
 namespace oos {
 
+namespace {
+
+unsigned long next_statement_cache_key()
+{
+  // keys are never reused, so a connection can't
+  // mistake the statements of a destroyed table
+  static std::atomic<unsigned long> key(0);
+  return ++key;
+}
+
+}
+
 basic_table::basic_table(prototype_node *node, persistence &p)
   : persistence_(p)
   , node_(node)
+  , statement_cache_key_(next_statement_cache_key())
 { }
 
 basic_table::~basic_table() {}
@@ -25,6 +40,21 @@ bool basic_table::is_loaded() const
   return is_loaded_;
 }
 
+void basic_table::load_chunked(connection &conn, object_store &p, std::size_t, const t_load_progress_func &progress)
+{
+  load(conn, p);
+  if (progress) {
+    progress(name(), node_->size());
+  }
+}
+
+void basic_table::fetch(connection &, std::size_t, const t_load_progress_func &) { }
+
+void basic_table::merge_fetched(object_store &p)
+{
+  load(conn(), p);
+}
+
 basic_table::t_table_map::iterator basic_table::find_table(const std::string &type)
 {
   return persistence_.find_table(type);
@@ -40,6 +70,54 @@ basic_table::t_table_map::iterator basic_table::end_table()
   return persistence_.end();
 }
 
+void basic_table::insert_batch(connection &conn, const std::vector<object_proxy*> &proxies)
+{
+  for (object_proxy *proxy : proxies) {
+    insert(conn, proxy);
+  }
+}
+
+void basic_table::remove_batch(connection &conn, const std::vector<object_proxy*> &proxies)
+{
+  for (object_proxy *proxy : proxies) {
+    remove(conn, proxy);
+  }
+}
+
+void basic_table::load_object(object_proxy *) { }
+
+std::size_t basic_table::max_batch_rows(std::size_t column_count)
+{
+  // SQLITE_MAX_VARIABLE_NUMBER of SQLite before 3.32
+  static const std::size_t max_host_variables = 999;
+  if (column_count == 0 || column_count >= max_host_variables) {
+    return 1;
+  }
+  return max_host_variables / column_count;
+}
+
+void basic_table::update_modified(connection &conn, object_proxy *proxy, detail::field_snapshot &)
+{
+  update(conn, proxy);
+}
+
+void basic_table::on_rollback() { }
+
+connection &basic_table::conn()
+{
+  return persistence_.conn();
+}
+
+prototype_node *basic_table::node() const
+{
+  return node_;
+}
+
+unsigned long basic_table::statement_cache_key() const
+{
+  return statement_cache_key_;
+}
+
 void basic_table::append_relation_items(const std::string &, detail::t_identifier_map &, basic_table::t_relation_item_map &) { }
 
 }
\ No newline at end of file
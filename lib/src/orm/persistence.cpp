@@ -7,8 +7,9 @@
 namespace oos {
 
 
-persistence::persistence(const std::string &dns)
+persistence::persistence(const std::string &dns, bool concurrent)
   : connection_(dns)
+  , store_(concurrent)
 {
   connection_.open();
 }
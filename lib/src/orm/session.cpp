@@ -4,11 +4,58 @@
 
 #include "orm/session.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace oos {
 
+namespace {
+
+/*
+ * Joins the given threads when leaving
+ * the scope, also if an exception is
+ * thrown while they are started
+ */
+class thread_joiner
+{
+public:
+  explicit thread_joiner(std::vector<std::thread> &threads)
+    : threads_(threads)
+  {}
+  ~thread_joiner()
+  {
+    for (std::thread &thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  thread_joiner(const thread_joiner&) = delete;
+  thread_joiner& operator=(const thread_joiner&) = delete;
+
+private:
+  std::vector<std::thread> &threads_;
+};
+
+}
+
 
 session::session(persistence &p)
   : persistence_(p)
+  , connection_(p.conn())
+  , observer_(new session_observer(*this))
+{
+
+}
+
+session::session(persistence &p, connection &conn)
+  : persistence_(p)
+  , connection_(conn)
   , observer_(new session_observer(*this))
 {
 
@@ -16,22 +63,76 @@ session::session(persistence &p)
 
 void session::load()
 {
-  prototype_iterator first = persistence_.store().begin();
-  prototype_iterator last = persistence_.store().end();
-  while (first != last) {
-    const prototype_node &node = (*first++);
-    if (node.is_abstract()) {
-      continue;
+  load(0);
+}
+
+void session::load(std::size_t chunk_size, const basic_table::t_load_progress_func &progress)
+{
+  for (const persistence::table_ptr &table : tables_to_load()) {
+//    std::cout << "loading table " << table->name() << "\n";
+    load(table, chunk_size, progress);
+  }
+}
+
+void session::load(connection_pool &pool, std::size_t chunk_size, const basic_table::t_load_progress_func &progress)
+{
+  std::vector<persistence::table_ptr> tables(tables_to_load());
+
+  std::mutex progress_mutex;
+  basic_table::t_load_progress_func report;
+  if (progress) {
+    report = [&progress_mutex, &progress](const std::string &name, unsigned long rows) {
+      std::lock_guard<std::mutex> lock(progress_mutex);
+      progress(name, rows);
+    };
+  }
+
+  /*
+   * each thread takes the next table not yet
+   * read until all tables are read. the tables
+   * only read their rows; neither the store nor
+   * any other table is touched
+   */
+  std::atomic<std::size_t> next(0);
+  std::vector<std::exception_ptr> errors(tables.size());
+  auto read_tables = [&]() {
+    connection_pool::pooled_connection conn;
+    for (std::size_t i = next++; i < tables.size(); i = next++) {
+      try {
+        if (!conn.valid()) {
+          conn = pool.acquire();
+        }
+        tables[i]->fetch(*conn, chunk_size, report);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
     }
+  };
 
-    // find corresponding table and load entities
-    persistence::t_table_map::iterator i = persistence_.find_table(node.type());
-    if (i == persistence_.end()) {
-      // Todo: replace with persistence exception
-      throw object_exception("couldn't find table");
+  std::size_t thread_count = std::min(pool.max_size(), tables.size());
+  {
+    std::vector<std::thread> threads;
+    // a started thread must not be lost
+    // to a reallocation failure
+    threads.reserve(thread_count);
+    thread_joiner joiner(threads);
+    for (std::size_t t = 1; t < thread_count; ++t) {
+      threads.push_back(std::thread(read_tables));
+    }
+    // the calling thread reads as well
+    read_tables();
+  }
+
+  for (std::exception_ptr &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
     }
-//    std::cout << "loading table " << i->second->name() << "\n";
-    load(i->second);
+  }
+
+  // insert the objects and resolve the relations
+  // in the order of the sequential load
+  for (const persistence::table_ptr &table : tables) {
+    table->merge_fetched(persistence_.store());
   }
 }
 
@@ -42,6 +143,16 @@ transaction session::begin()
   return persistence_.store().current_transaction();
 }
 
+void session::insert_batch_size(std::size_t size)
+{
+  insert_batch_size_ = (size == 0 ? 1 : size);
+}
+
+std::size_t session::insert_batch_size() const
+{
+  return insert_batch_size_;
+}
+
 object_store &session::store()
 {
   return persistence_.store();
@@ -52,9 +163,36 @@ const object_store &session::store() const
   return persistence_.store();
 }
 
-void session::load(const persistence::table_ptr &table)
+connection &session::conn()
+{
+  return connection_;
+}
+
+std::vector<persistence::table_ptr> session::tables_to_load()
+{
+  std::vector<persistence::table_ptr> tables;
+  prototype_iterator first = persistence_.store().begin();
+  prototype_iterator last = persistence_.store().end();
+  while (first != last) {
+    const prototype_node &node = (*first++);
+    if (node.is_abstract()) {
+      continue;
+    }
+
+    // find corresponding table
+    persistence::t_table_map::iterator i = persistence_.find_table(node.type());
+    if (i == persistence_.end()) {
+      // Todo: replace with persistence exception
+      throw object_exception("couldn't find table");
+    }
+    tables.push_back(i->second);
+  }
+  return tables;
+}
+
+void session::load(const persistence::table_ptr &table, std::size_t chunk_size, const basic_table::t_load_progress_func &progress)
 {
-  table->load(persistence_.store());
+  table->load_chunked(connection_, persistence_.store(), chunk_size, progress);
 }
 
 session::session_observer::session_observer(session &s)
@@ -67,17 +205,27 @@ void session::session_observer::on_begin()
 
 void session::session_observer::on_commit(transaction::t_action_vector &actions)
 {
-  session_.persistence_.conn().begin();
+  session_.connection_.begin();
 
   for (transaction::action_ptr &actptr : actions) {
     actptr->accept(this);
   }
-  session_.persistence_.conn().commit();
+  flush_deletes();
+  session_.connection_.commit();
 }
 
 void session::session_observer::on_rollback()
 {
-  session_.persistence_.conn().rollback();
+  // the actions of the pending deletions
+  // are destroyed with the transaction
+  deletes_.clear();
+  delete_table_.reset();
+  session_.connection_.rollback();
+  // the rolled back statements may have
+  // changed the state kept by the tables
+  for (auto &t : session_.persistence_) {
+    t.second->on_rollback();
+  }
 }
 
 void session::session_observer::visit(insert_action *act)
@@ -88,12 +236,26 @@ void session::session_observer::visit(insert_action *act)
     return;
   }
 
+  flush_deletes();
+
+  std::size_t batch_size = session_.insert_batch_size_;
+  batch_.clear();
+  batch_.reserve(batch_size);
+
   insert_action::const_iterator first = act->begin();
   insert_action::const_iterator last = act->end();
   while (first != last) {
-    i->second->insert((*first++));
+    batch_.push_back(*first++);
+    if (batch_.size() == batch_size) {
+      i->second->insert_batch(session_.connection_, batch_);
+      batch_.clear();
+    }
   }
-
+  // insert the remaining objects one by one
+  for (object_proxy *proxy : batch_) {
+    i->second->insert(session_.connection_, proxy);
+  }
+  batch_.clear();
 }
 
 void session::session_observer::visit(update_action *act)
@@ -104,7 +266,12 @@ void session::session_observer::visit(update_action *act)
     return;
   }
 
-  i->second->update(act->proxy());
+  flush_deletes();
+  if (act->has_snapshot()) {
+    i->second->update_modified(session_.connection_, act->proxy(), act->snapshot());
+  } else {
+    i->second->update(session_.connection_, act->proxy());
+  }
 }
 
 void session::session_observer::visit(delete_action *act)
@@ -115,9 +282,41 @@ void session::session_observer::visit(delete_action *act)
     return;
   }
 
-  i->second->remove(act->proxy());
+  if (i->second != delete_table_) {
+    flush_deletes();
+    delete_table_ = i->second;
+  }
+  deletes_.push_back(act);
+  if (deletes_.size() == session_.insert_batch_size_) {
+    flush_deletes();
+  }
+}
+
+void session::session_observer::flush_deletes()
+{
+  // take the pending deletions first, so a failing
+  // statement doesn't leave them for the next commit
+  std::vector<delete_action*> deletes;
+  deletes.swap(deletes_);
+  persistence::table_ptr table;
+  table.swap(delete_table_);
 
-  act->mark_deleted();
+  if (deletes.empty()) {
+    return;
+  }
+  if (deletes.size() == 1) {
+    table->remove(session_.connection_, deletes.front()->proxy());
+  } else {
+    batch_.clear();
+    for (delete_action *act : deletes) {
+      batch_.push_back(act->proxy());
+    }
+    table->remove_batch(session_.connection_, batch_);
+    batch_.clear();
+  }
+  for (delete_action *act : deletes) {
+    act->mark_deleted();
+  }
 }
 
 
@@ -4,6 +4,7 @@
 #include "sql/basic_dialect.hpp"
 #include "sql/basic_dialect_compiler.hpp"
 #include "sql/basic_dialect_linker.hpp"
+#include "sql/statement_key_builder.hpp"
 #include "sql/sql.hpp"
 
 namespace oos {
@@ -40,7 +41,30 @@ std::string basic_dialect::direct(const sql &s)
 
 std::string basic_dialect::prepare(const sql &s)
 {
-  return build(s, PREPARED);
+  detail::statement_key_builder key_builder;
+  std::string key(key_builder.build(s));
+
+  auto i = compiled_statements_.find(key);
+  if (i != compiled_statements_.end()) {
+    bind_count_ = i->second.bind_count;
+    column_count_ = i->second.column_count;
+    return i->second.sql;
+  }
+
+  bind_count_ = 0;
+  column_count_ = 0;
+  std::string result(build(s, PREPARED));
+
+  if (compiled_statements_.size() >= max_compiled_statements) {
+    compiled_statements_.clear();
+  }
+  compiled_statements_.insert(std::make_pair(std::move(key), compiled_statement{result, bind_count_, column_count_}));
+  return result;
+}
+
+size_t basic_dialect::cached_statement_count() const
+{
+  return compiled_statements_.size();
 }
 
 std::string basic_dialect::build(const sql &s, t_compile_type compile_type)
@@ -73,6 +97,7 @@ bool basic_dialect::is_preparing() const
 void basic_dialect::replace_token(detail::token::t_token tkn, const std::string &value)
 {
   tokens[tkn] = value;
+  compiled_statements_.clear();
 }
 
 void basic_dialect::append_to_result(const std::string &part)
@@ -57,6 +57,8 @@ void basic_dialect_compiler::visit(const oos::detail::basic_value_column &) { }
 
 void basic_dialect_compiler::visit(const oos::detail::from &) { }
 
+void basic_dialect_compiler::visit(const oos::detail::left_join &) { }
+
 void basic_dialect_compiler::visit(const oos::detail::where &) { }
 
 void basic_dialect_compiler::visit(const oos::detail::basic_condition &) { }
@@ -96,18 +96,26 @@ void basic_dialect_linker::visit(const oos::detail::remove &del)
 
 void basic_dialect_linker::visit(const oos::detail::values &values)
 {
-  dialect().append_to_result(token_string(values.type) + " (");
+  dialect().append_to_result(token_string(values.type) + " ");
 
-  if (values.values_.size() > 1) {
-    std::for_each(values.values_.begin(), values.values_.end() - 1, [&](const std::shared_ptr<detail::basic_value> &val) {
-      val->accept(*this);
+  // each row gets its own value list
+  for (std::size_t row = 0; row < values.rows_; ++row) {
+    if (row > 0) {
       dialect().append_to_result(", ");
-    });
-  }
-  if (!values.values_.empty()) {
-    values.values_.back()->accept(*this);
+    }
+    dialect().append_to_result("(");
+    if (values.values_.size() > 1) {
+      std::for_each(values.values_.begin(), values.values_.end() - 1, [&](const std::shared_ptr<detail::basic_value> &val) {
+        val->accept(*this);
+        dialect().append_to_result(", ");
+      });
+    }
+    if (!values.values_.empty()) {
+      values.values_.back()->accept(*this);
+    }
+    dialect().append_to_result(")");
   }
-  dialect().append_to_result(") ");
+  dialect().append_to_result(" ");
 }
 
 void basic_dialect_linker::visit(const oos::detail::basic_value &val)
@@ -150,6 +158,11 @@ void basic_dialect_linker::visit(const oos::detail::from &from)
   dialect().append_to_result(token_string(from.type) + " " + from.table + " ");
 }
 
+void basic_dialect_linker::visit(const oos::detail::left_join &join)
+{
+  dialect().append_to_result(token_string(join.type) + " " + join.table + " ON " + join.left_column + " = " + join.right_column + " ");
+}
+
 void basic_dialect_linker::visit(const oos::detail::where &where)
 {
   dialect().append_to_result(token_string(where.type) + " ");
@@ -255,6 +268,11 @@ void basic_dialect_linker::append_to_result(basic_dialect &dialect, const std::s
   dialect.append_to_result(part);
 }
 
+bool basic_dialect_linker::is_direct(const basic_dialect &dialect) const
+{
+  return dialect.compile_type() == basic_dialect::DIRECT;
+}
+
 void basic_dialect_linker::dialect(basic_dialect *d)
 {
   dialect_ = d;
@@ -74,6 +74,7 @@ void basic_query::throw_invalid(state_t next, state_t current)
           current != basic_query::QUERY_SET &&
           current != basic_query::QUERY_DELETE &&
           current != basic_query::QUERY_FROM &&
+          current != basic_query::QUERY_JOIN &&
           current != basic_query::QUERY_COND_WHERE)
       {
         msg << "invalid next state: [" << state2text(next) << "] (current: " << state2text(current) << ")";
@@ -94,6 +95,14 @@ void basic_query::throw_invalid(state_t next, state_t current)
         throw std::logic_error(msg.str());
       }
       break;
+    case basic_query::QUERY_JOIN:
+      if (current != basic_query::QUERY_FROM &&
+          current != basic_query::QUERY_JOIN)
+      {
+        msg << "invalid next state: [" << state2text(next) << "] (current: " << state2text(current) << ")";
+        throw std::logic_error(msg.str());
+      }
+      break;
     case basic_query::QUERY_SET:
       if (current != basic_query::QUERY_UPDATE &&
           current != basic_query::QUERY_SET)
@@ -106,6 +115,7 @@ void basic_query::throw_invalid(state_t next, state_t current)
       if (current != basic_query::QUERY_SELECT &&
           current != basic_query::QUERY_WHERE &&
           current != basic_query::QUERY_FROM &&
+          current != basic_query::QUERY_JOIN &&
           current != basic_query::QUERY_COND_WHERE)
       {
         msg << "invalid next state: [" << state2text(next) << "] (current: " << state2text(current) << ")";
@@ -146,6 +156,8 @@ std::string basic_query::state2text(basic_query::state_t state)
       return "set";
     case QUERY_FROM:
       return "from";
+    case QUERY_JOIN:
+      return "join";
     case QUERY_WHERE:
       return "where";
     case QUERY_COND_WHERE:
@@ -2,12 +2,18 @@
 #include "sql/connection.hpp"
 #include "sql/column.hpp"
 #include "sql/value.hpp"
+#include "sql/basic_dialect.hpp"
 
 namespace oos {
 
-connection::connection() {}
+const std::size_t connection::default_statement_cache_capacity;
+
+connection::connection()
+  : prepared_statements_(std::make_shared<detail::prepared_statement_cache>(default_statement_cache_capacity))
+{}
 
 connection::connection(const std::string &dns)
+  : prepared_statements_(std::make_shared<detail::prepared_statement_cache>(default_statement_cache_capacity))
 {
   parse_dns(dns);
   impl_.reset(create_connection(type_));
@@ -16,6 +22,7 @@ connection::connection(const std::string &dns)
 connection::connection(const connection &x)
   : type_(x.type_)
   , dns_(x.dns_)
+  , prepared_statements_(std::make_shared<detail::prepared_statement_cache>(x.statement_cache_capacity()))
 {
   init_from_foreign_connection(x);
 }
@@ -24,6 +31,8 @@ connection::connection(connection &&x)
   : type_(std::move(x.type_))
   , dns_(std::move(x.dns_))
   , impl_(std::move(x.impl_))
+  , statement_caches_(std::move(x.statement_caches_))
+  , prepared_statements_(std::move(x.prepared_statements_))
 {}
 
 connection &connection::operator=(const connection &x)
@@ -31,6 +40,8 @@ connection &connection::operator=(const connection &x)
   type_ = x.type_;
   dns_ = x.dns_;
 
+  statement_caches_.clear();
+  prepared_statements_ = std::make_shared<detail::prepared_statement_cache>(x.statement_cache_capacity());
   init_from_foreign_connection(x);
 
   return *this;
@@ -38,14 +49,21 @@ connection &connection::operator=(const connection &x)
 
 connection &connection::operator=(connection &&x)
 {
+  statement_caches_.clear();
+  prepared_statements_.reset();
   type_ = std::move(x.type_);
   dns_ = std::move(x.dns_);
   impl_ = std::move(x.impl_);
+  statement_caches_ = std::move(x.statement_caches_);
+  prepared_statements_ = std::move(x.prepared_statements_);
   return *this;
 }
 
 connection::~connection()
 {
+  // cached statements must go before the connection
+  statement_caches_.clear();
+  prepared_statements_.reset();
   if (!impl_) {
     return;
   }
@@ -68,6 +86,8 @@ void connection::open()
   if (is_open()) {
     return;
   } else {
+    statement_caches_.clear();
+    reset_prepared_statements();
     if (impl_) {
       connection_factory::instance().destroy(type_, impl_.release());
     }
@@ -83,6 +103,8 @@ bool connection::is_open() const
 
 void connection::close()
 {
+  statement_caches_.clear();
+  reset_prepared_statements();
   impl_->close();
 }
 
@@ -131,6 +153,66 @@ bool connection::is_valid() const
   return !type_.empty() && !dns_.empty();
 }
 
+detail::basic_statement_cache* connection::statement_cache(unsigned long key) const
+{
+  t_statement_cache_map::const_iterator i = statement_caches_.find(key);
+  return i == statement_caches_.end() ? nullptr : i->second.get();
+}
+
+detail::basic_statement_cache* connection::statement_cache(unsigned long key, std::unique_ptr<detail::basic_statement_cache> cache)
+{
+  std::unique_ptr<detail::basic_statement_cache> &entry = statement_caches_[key];
+  entry = std::move(cache);
+  return entry.get();
+}
+
+void connection::statement_cache_capacity(std::size_t capacity)
+{
+  prepared_statements_->capacity(capacity);
+}
+
+std::size_t connection::statement_cache_capacity() const
+{
+  return prepared_statements_ ? prepared_statements_->capacity() : default_statement_cache_capacity;
+}
+
+std::size_t connection::statement_cache_hits() const
+{
+  return prepared_statements_->hits();
+}
+
+std::size_t connection::statement_cache_misses() const
+{
+  return prepared_statements_->misses();
+}
+
+std::size_t connection::cached_statement_count() const
+{
+  return prepared_statements_->size();
+}
+
+detail::statement_impl* connection::acquire_statement(const oos::sql &sql)
+{
+  basic_dialect *d = impl_->dialect();
+  if (d == nullptr) {
+    return impl_->prepare(sql);
+  }
+  // the cache is keyed by the final sql string
+  detail::statement_impl *stmt = prepared_statements_->acquire(d->prepare(sql));
+  if (stmt == nullptr) {
+    stmt = impl_->prepare(sql);
+  }
+  return stmt;
+}
+
+void connection::reset_prepared_statements()
+{
+  // the idle statements are deleted and
+  // statements still in use aren't returned
+  // to the new cache
+  prepared_statements_ = std::make_shared<detail::prepared_statement_cache>(statement_cache_capacity());
+}
+
 detail::basic_value* create_default_value(data_type type);
 
 void connection::prepare_prototype_row(row &prototype, const std::string &tablename)
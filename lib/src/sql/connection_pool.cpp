@@ -0,0 +1,205 @@
+#include "sql/connection_pool.hpp"
+
+#include <algorithm>
+
+namespace oos {
+
+connection_pool::pooled_connection::pooled_connection() {}
+
+connection_pool::pooled_connection::pooled_connection(connection_pool *pool, connection *conn)
+  : pool_(pool)
+  , connection_(conn)
+{}
+
+connection_pool::pooled_connection::pooled_connection(pooled_connection &&x)
+  : pool_(x.pool_)
+  , connection_(x.connection_)
+{
+  x.pool_ = nullptr;
+  x.connection_ = nullptr;
+}
+
+connection_pool::pooled_connection &connection_pool::pooled_connection::operator=(pooled_connection &&x)
+{
+  if (this != &x) {
+    release();
+    pool_ = x.pool_;
+    connection_ = x.connection_;
+    x.pool_ = nullptr;
+    x.connection_ = nullptr;
+  }
+  return *this;
+}
+
+connection_pool::pooled_connection::~pooled_connection()
+{
+  release();
+}
+
+void connection_pool::pooled_connection::release()
+{
+  if (pool_ != nullptr && connection_ != nullptr) {
+    pool_->release(connection_);
+  }
+  pool_ = nullptr;
+  connection_ = nullptr;
+}
+
+bool connection_pool::pooled_connection::valid() const
+{
+  return connection_ != nullptr;
+}
+
+connection &connection_pool::pooled_connection::operator*() const
+{
+  return *connection_;
+}
+
+connection *connection_pool::pooled_connection::operator->() const
+{
+  return connection_;
+}
+
+connection *connection_pool::pooled_connection::get() const
+{
+  return connection_;
+}
+
+connection_pool::connection_pool(const std::string &dns, std::size_t max_size)
+  : dns_(dns)
+  , max_size_(max_size == 0 ? 1 : max_size)
+{}
+
+connection_pool::~connection_pool()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_connections_.clear();
+  connections_.clear();
+}
+
+connection_pool::pooled_connection connection_pool::acquire()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  available_.wait(lock, [this]() {
+    return !idle_connections_.empty() || size_ < max_size_;
+  });
+  return pooled_connection(this, checkout(lock));
+}
+
+connection_pool::pooled_connection connection_pool::acquire(const std::chrono::milliseconds &timeout)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool available = available_.wait_for(lock, timeout, [this]() {
+    return !idle_connections_.empty() || size_ < max_size_;
+  });
+  if (!available) {
+    return pooled_connection();
+  }
+  return pooled_connection(this, checkout(lock));
+}
+
+void connection_pool::health_check(const t_health_check &check)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  health_check_ = check;
+}
+
+std::size_t connection_pool::max_size() const
+{
+  return max_size_;
+}
+
+std::size_t connection_pool::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connections_.size();
+}
+
+std::size_t connection_pool::idle() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_connections_.size();
+}
+
+connection *connection_pool::checkout(std::unique_lock<std::mutex> &lock)
+{
+  // expects the locked mutex and a connection
+  // being available; the lock is released while
+  // the connection is checked or opened
+  if (!idle_connections_.empty()) {
+    // the most recently returned connection is
+    // the one most likely having the needed
+    // statements already prepared
+    connection *conn = idle_connections_.back();
+    idle_connections_.pop_back();
+    t_health_check check = health_check_;
+    lock.unlock();
+    if (is_healthy(*conn, check)) {
+      return conn;
+    }
+    try {
+      // reopening drops the prepared statements
+      if (conn->is_open()) {
+        conn->close();
+      }
+      conn->open();
+    } catch (...) {
+      discard(conn);
+      throw;
+    }
+    return conn;
+  }
+
+  ++size_;
+  lock.unlock();
+  std::unique_ptr<connection> conn;
+  try {
+    conn.reset(new connection(dns_));
+    conn->open();
+  } catch (...) {
+    lock.lock();
+    --size_;
+    available_.notify_one();
+    throw;
+  }
+  lock.lock();
+  connections_.push_back(std::move(conn));
+  return connections_.back().get();
+}
+
+bool connection_pool::is_healthy(connection &conn, const t_health_check &check) const
+{
+  if (!conn.is_open()) {
+    return false;
+  }
+  if (!check) {
+    return true;
+  }
+  try {
+    return check(conn);
+  } catch (...) {
+    return false;
+  }
+}
+
+void connection_pool::discard(connection *conn)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto i = std::find_if(connections_.begin(), connections_.end(), [conn](const std::unique_ptr<connection> &c) {
+    return c.get() == conn;
+  });
+  if (i != connections_.end()) {
+    connections_.erase(i);
+  }
+  --size_;
+  available_.notify_one();
+}
+
+void connection_pool::release(connection *conn)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_connections_.push_back(conn);
+  available_.notify_one();
+}
+
+}
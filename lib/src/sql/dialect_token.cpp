@@ -109,6 +109,15 @@ void from::accept(token_visitor &visitor)
   visitor.visit(*this);
 }
 
+left_join::left_join(const std::string &t, const std::string &l, const std::string &r)
+  : token(LEFT_JOIN), table(t), left_column(l), right_column(r)
+{}
+
+void left_join::accept(token_visitor &visitor)
+{
+  visitor.visit(*this);
+}
+
 top::top(size_t lmt)
   : token(TOP), limit_(lmt)
 {}
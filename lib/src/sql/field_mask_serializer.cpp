@@ -0,0 +1,147 @@
+#include "sql/field_mask_serializer.hpp"
+
+namespace oos {
+
+namespace detail {
+
+field_mask_serializer::field_mask_serializer(serializer &s, const std::vector<bool> &mask)
+  : serializer_(s)
+  , mask_(mask)
+{}
+
+void field_mask_serializer::serialize(const char *id, char &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, short &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, int &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, long &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, unsigned char &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, unsigned short &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, unsigned int &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, unsigned long &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, bool &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, float &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, double &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, char *x, size_t s)
+{
+  if (next()) {
+    serializer_.serialize(id, x, s);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, std::string &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, varchar_base &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, time &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, date &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, basic_identifier &x)
+{
+  if (next()) {
+    serializer_.serialize(id, x);
+  }
+}
+
+void field_mask_serializer::serialize(const char *id, identifiable_holder &x, cascade_type cascade)
+{
+  if (next()) {
+    serializer_.serialize(id, x, cascade);
+  }
+}
+
+bool field_mask_serializer::next()
+{
+  // each serialize call represents one field
+  bool masked = index_ < mask_.size() && mask_[index_];
+  ++index_;
+  return masked;
+}
+
+}
+}
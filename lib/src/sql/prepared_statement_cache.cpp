@@ -0,0 +1,110 @@
+#include "sql/prepared_statement_cache.hpp"
+#include "sql/statement_impl.hpp"
+
+namespace oos {
+
+namespace detail {
+
+prepared_statement_cache::prepared_statement_cache(std::size_t capacity)
+  : capacity_(capacity)
+{}
+
+prepared_statement_cache::~prepared_statement_cache()
+{
+  clear();
+}
+
+statement_impl *prepared_statement_cache::acquire(const std::string &sql)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  t_cache_map::iterator i = statement_map_.find(sql);
+  if (i == statement_map_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  statement_impl *stmt = i->second->second.release();
+  statements_.erase(i->second);
+  statement_map_.erase(i);
+  return stmt;
+}
+
+void prepared_statement_cache::release(statement_impl *stmt)
+{
+  std::unique_ptr<statement_impl> entry(stmt);
+  try {
+    entry->reset();
+    entry->result_mode(t_result_mode::BUFFERED);
+  } catch (...) {
+    // a statement which couldn't
+    // be reset isn't reused
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0 || statement_map_.find(entry->str()) != statement_map_.end()) {
+    return;
+  }
+  std::string sql(entry->str());
+  statements_.emplace_front(sql, std::move(entry));
+  statement_map_.insert(std::make_pair(sql, statements_.begin()));
+  shrink(capacity_);
+}
+
+void prepared_statement_cache::release(const std::weak_ptr<prepared_statement_cache> &cache, statement_impl *stmt)
+{
+  std::shared_ptr<prepared_statement_cache> c = cache.lock();
+  if (c) {
+    c->release(stmt);
+  } else {
+    delete stmt;
+  }
+}
+
+void prepared_statement_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  shrink(0);
+}
+
+void prepared_statement_cache::capacity(std::size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  shrink(capacity_);
+}
+
+std::size_t prepared_statement_cache::capacity() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+std::size_t prepared_statement_cache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statements_.size();
+}
+
+std::size_t prepared_statement_cache::hits() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+std::size_t prepared_statement_cache::misses() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void prepared_statement_cache::shrink(std::size_t capacity)
+{
+  while (statements_.size() > capacity) {
+    statement_map_.erase(statements_.back().first);
+    statements_.pop_back();
+  }
+}
+
+}
+
+}
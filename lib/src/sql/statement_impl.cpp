@@ -3,6 +3,8 @@
 //
 #include "sql/statement_impl.hpp"
 
+#include <stdexcept>
+
 namespace oos {
 
 namespace detail {
@@ -20,6 +22,28 @@ void statement_impl::str(const std::string &s)
   sql_ = s;
 }
 
+void statement_impl::result_mode(t_result_mode mode)
+{
+  result_mode_ = mode;
+}
+
+t_result_mode statement_impl::result_mode() const
+{
+  return result_mode_;
+}
+
+std::size_t statement_impl::max_parameter_sets() const
+{
+  return 1;
+}
+
+void statement_impl::parameter_set(std::size_t set)
+{
+  if (set >= max_parameter_sets()) {
+    throw std::logic_error("statement can't bind parameter set");
+  }
+}
+
 }
 
 }
\ No newline at end of file
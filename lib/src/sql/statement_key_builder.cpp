@@ -0,0 +1,247 @@
+#include "sql/statement_key_builder.hpp"
+#include "sql/dialect_token.hpp"
+#include "sql/sql.hpp"
+
+namespace oos {
+
+namespace detail {
+
+std::string statement_key_builder::build(const sql &s)
+{
+  key_.clear();
+  for (auto &tokptr : s.token_list_) {
+    tokptr->accept(*this);
+  }
+  return key_;
+}
+
+void statement_key_builder::visit(const oos::detail::create &create)
+{
+  append(create.type);
+  append(create.table);
+}
+
+void statement_key_builder::visit(const oos::detail::drop &drop)
+{
+  append(drop.type);
+  append(drop.table);
+}
+
+void statement_key_builder::visit(const oos::detail::select &select)
+{
+  append(select.type);
+}
+
+void statement_key_builder::visit(const oos::detail::distinct &distinct)
+{
+  append(distinct.type);
+}
+
+void statement_key_builder::visit(const oos::detail::update &update)
+{
+  append(update.type);
+}
+
+void statement_key_builder::visit(const oos::detail::tablename &table)
+{
+  append(table.type);
+  append(table.tab);
+}
+
+void statement_key_builder::visit(const oos::detail::set &set)
+{
+  append(set.type);
+}
+
+void statement_key_builder::visit(const oos::detail::as &alias)
+{
+  append(alias.type);
+  append(alias.alias);
+}
+
+void statement_key_builder::visit(const oos::detail::top &top)
+{
+  append(top.type);
+  append(std::to_string(top.limit_));
+}
+
+void statement_key_builder::visit(const oos::detail::remove &del)
+{
+  append(del.type);
+}
+
+void statement_key_builder::visit(const oos::detail::values &values)
+{
+  // values are bound, only their
+  // count is part of the key
+  append(values.type);
+  append(std::to_string(values.rows_));
+  append(std::to_string(values.values_.size()));
+}
+
+void statement_key_builder::visit(const oos::detail::basic_value &val)
+{
+  append(val.type);
+}
+
+void statement_key_builder::visit(const oos::detail::order_by &by)
+{
+  append(by.type);
+  append(by.column);
+}
+
+void statement_key_builder::visit(const oos::detail::asc &asc)
+{
+  append(asc.type);
+}
+
+void statement_key_builder::visit(const oos::detail::desc &desc)
+{
+  append(desc.type);
+}
+
+void statement_key_builder::visit(const oos::detail::group_by &by)
+{
+  append(by.type);
+  append(by.column);
+}
+
+void statement_key_builder::visit(const oos::detail::insert &insert)
+{
+  append(insert.type);
+  append(insert.table);
+}
+
+void statement_key_builder::visit(const oos::detail::from &from)
+{
+  append(from.type);
+  append(from.table);
+}
+
+void statement_key_builder::visit(const oos::detail::left_join &join)
+{
+  append(join.type);
+  append(join.table);
+  append(join.left_column);
+  append(join.right_column);
+}
+
+void statement_key_builder::visit(const oos::detail::where &where)
+{
+  append(where.type);
+  where.cond->accept(*this);
+}
+
+void statement_key_builder::visit(const oos::detail::basic_condition &cond)
+{
+  // the key of a condition contains
+  // placeholders instead of the values
+  append(cond.type);
+  cond.append_key(key_);
+  key_ += '\x1f';
+}
+
+void statement_key_builder::visit(const oos::detail::basic_column_condition &cond)
+{
+  append(cond.type);
+  cond.append_key(key_);
+  key_ += '\x1f';
+}
+
+void statement_key_builder::visit(const oos::detail::basic_in_condition &cond)
+{
+  append(cond.type);
+  cond.append_key(key_);
+  key_ += '\x1f';
+}
+
+void statement_key_builder::visit(const oos::columns &cols)
+{
+  append(cols.type);
+  append((int)cols.with_brackets_);
+  for (auto &col : cols.columns_) {
+    col->accept(*this);
+  }
+}
+
+void statement_key_builder::visit(const oos::column &col)
+{
+  append((int)col.type);
+  append(col.name);
+}
+
+void statement_key_builder::visit(const oos::detail::typed_column &col)
+{
+  append("typed");
+  append(col.name);
+  append((int)col.type);
+}
+
+void statement_key_builder::visit(const oos::detail::typed_identifier_column &col)
+{
+  append("identifier");
+  append(col.name);
+  append((int)col.type);
+}
+
+void statement_key_builder::visit(const oos::detail::typed_varchar_column &col)
+{
+  append("varchar");
+  append(col.name);
+  append((int)col.type);
+  append(std::to_string(col.size));
+}
+
+void statement_key_builder::visit(const oos::detail::identifier_varchar_column &col)
+{
+  append("identifier_varchar");
+  append(col.name);
+  append((int)col.type);
+  append(std::to_string(col.size));
+}
+
+void statement_key_builder::visit(const oos::detail::basic_value_column &col)
+{
+  append("value");
+  append(col.name);
+  col.value_->accept(*this);
+}
+
+void statement_key_builder::visit(const oos::detail::begin &begin)
+{
+  append(begin.type);
+}
+
+void statement_key_builder::visit(const oos::detail::commit &commit)
+{
+  append(commit.type);
+}
+
+void statement_key_builder::visit(const oos::detail::rollback &rollback)
+{
+  append(rollback.type);
+}
+
+void statement_key_builder::visit(oos::detail::query &q)
+{
+  append(q.type);
+  statement_key_builder builder;
+  append(builder.build(q.sql_));
+  append(")");
+}
+
+void statement_key_builder::append(const std::string &part)
+{
+  key_ += part;
+  key_ += '\x1f';
+}
+
+void statement_key_builder::append(int tok)
+{
+  key_ += std::to_string(tok);
+  key_ += '\x1f';
+}
+
+}
+
+}
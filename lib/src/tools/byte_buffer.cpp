@@ -17,12 +17,13 @@
 
 #include "tools/byte_buffer.hpp"
 
+#include <cstring>
+#include <stdexcept>
+
 namespace oos {
 
 byte_buffer::byte_buffer()
-{
-  chunk_list_.push_back(buffer_chunk());
-}
+{}
 
 byte_buffer::~byte_buffer()
 {}
@@ -30,71 +31,42 @@ byte_buffer::~byte_buffer()
 void byte_buffer::append(const void *bytes, byte_buffer::size_type size)
 {
   const char *ptr = (const char*)bytes;
-  size_type bytes_written = 0;
-  while (chunk_list_.back().available() < size) {
-    buffer_chunk &chunk = chunk_list_.back();
-    // copy first part of bytes
-    std::copy(ptr+bytes_written, ptr+bytes_written+chunk.available(), &chunk.data[chunk.write_cursor]);
-    // adjust remaining size
-    size -= chunk.available();
-    // adjust written bytes
-    bytes_written += chunk.available();
-    // adjust cursor
-    chunk.write_cursor += chunk.available();
-    // append new buffer chunk
-    chunk_list_.push_back(buffer_chunk());
-  }
-  if (size > 0) {
-    buffer_chunk &chunk = chunk_list_.back();
-    // append remaining bytes
-    std::copy(ptr+bytes_written, ptr+bytes_written+size, &chunk.data[chunk.write_cursor]);
-    chunk.write_cursor += size;
-  }
+  data_.insert(data_.end(), ptr, ptr + size);
 }
 
 void byte_buffer::release(void *bytes, byte_buffer::size_type size)
 {
-  char *ptr = (char*)bytes;
-  size_type bytes_read = 0;
-  while (!chunk_list_.empty() && chunk_list_.front().used() <= size) {
-    buffer_chunk &chunk = chunk_list_.front();
-    // available bytes are not enough
-    // copy first part
-    std::copy(chunk.data.begin()+chunk.read_cursor, chunk.data.begin()+chunk.read_cursor+chunk.used(), ptr+bytes_read);
-    // adjust remaining size
-    size -= chunk.used();
-    // adjust bytes read
-    bytes_read += chunk.used();
-    // pop back
-    chunk_list_.pop_front();
-    // get next chunk
+  if (size > data_.size() - read_cursor_) {
+    throw std::out_of_range("byte_buffer: not enough bytes to release");
   }
   if (size > 0) {
-    buffer_chunk &chunk = chunk_list_.front();
-    // copy rest of bytes
-    std::copy(chunk.data.begin()+chunk.read_cursor, chunk.data.begin()+chunk.read_cursor+size, ptr+bytes_read);
-    // adjust read cursor
-    chunk.read_cursor += size;
-  }
-  if (chunk_list_.empty()) {
-    chunk_list_.push_back(buffer_chunk());
+    std::memcpy(bytes, &data_[read_cursor_], size);
+    read_cursor_ += size;
   }
 }
 
 byte_buffer::size_type byte_buffer::size() const
 {
-  return (chunk_list_.size() * BUF_SIZE) - chunk_list_.back().available() - chunk_list_.front().released();
-  if (chunk_list_.size() == 1) {
-    return BUF_SIZE - chunk_list_.front().available();
-  } else {
-    return (chunk_list_.size() * BUF_SIZE) - chunk_list_.back().available();
+  return data_.size() - read_cursor_;
+}
+
+byte_buffer::size_type byte_buffer::position() const
+{
+  return data_.size();
+}
+
+void byte_buffer::seek(byte_buffer::size_type pos)
+{
+  if (pos > data_.size()) {
+    throw std::out_of_range("byte_buffer: position is out of range");
   }
+  read_cursor_ = pos;
 }
 
 void byte_buffer::clear()
 {
-  chunk_list_.clear();
-  chunk_list_.push_back(buffer_chunk());
+  data_.clear();
+  read_cursor_ = 0;
 }
 
 }
@@ -0,0 +1,120 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/rw_mutex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace oos {
+
+namespace {
+
+#ifndef NDEBUG
+/*
+ * The mutexes the current thread holds a
+ * shared lock of. Only used to assert that
+ * a shared lock isn't upgraded.
+ */
+std::vector<const rw_mutex*>& shared_locks()
+{
+  static thread_local std::vector<const rw_mutex*> locks;
+  return locks;
+}
+#endif
+
+}
+
+rw_mutex::rw_mutex()
+  : owner_(std::thread::id())
+{}
+
+rw_mutex::~rw_mutex() {}
+
+void rw_mutex::lock()
+{
+  if (is_owner()) {
+    ++depth_;
+    return;
+  }
+#ifndef NDEBUG
+  const std::vector<const rw_mutex*> &locks = shared_locks();
+  assert(std::find(locks.begin(), locks.end(), this) == locks.end() && "shared lock can't be upgraded");
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  ++waiting_writers_;
+  writers_cond_.wait(lock, [this]() { return !writer_ && readers_ == 0; });
+  --waiting_writers_;
+  writer_ = true;
+  owner_.store(std::this_thread::get_id());
+  depth_ = 1;
+}
+
+void rw_mutex::unlock()
+{
+  if (--depth_ > 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  owner_.store(std::thread::id());
+  writer_ = false;
+  if (waiting_writers_ > 0) {
+    writers_cond_.notify_one();
+  } else {
+    readers_cond_.notify_all();
+  }
+}
+
+void rw_mutex::lock_shared()
+{
+  if (is_owner()) {
+    // the writer may read
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  readers_cond_.wait(lock, [this]() { return !writer_ && waiting_writers_ == 0; });
+  ++readers_;
+#ifndef NDEBUG
+  shared_locks().push_back(this);
+#endif
+}
+
+void rw_mutex::unlock_shared()
+{
+  if (is_owner()) {
+    return;
+  }
+#ifndef NDEBUG
+  std::vector<const rw_mutex*> &locks = shared_locks();
+  auto i = std::find(locks.begin(), locks.end(), this);
+  if (i != locks.end()) {
+    locks.erase(i);
+  }
+#endif
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (--readers_ == 0 && waiting_writers_ > 0) {
+    writers_cond_.notify_one();
+  }
+}
+
+bool rw_mutex::is_owner() const
+{
+  return owner_.load() == std::this_thread::get_id();
+}
+
+}
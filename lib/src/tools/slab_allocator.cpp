@@ -0,0 +1,104 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/slab_allocator.hpp"
+
+#include <new>
+
+namespace oos {
+
+slab_allocator::slab_allocator(std::size_t block_size, std::size_t blocks_per_slab)
+  : blocks_per_slab_(blocks_per_slab == 0 ? 1 : blocks_per_slab)
+{
+  // each block must be able to hold the free list link
+  // and keeps the alignment of the largest scalar type
+  const std::size_t align = alignof(std::max_align_t);
+  block_size_ = block_size < sizeof(free_block) ? sizeof(free_block) : block_size;
+  block_size_ = (block_size_ + align - 1) / align * align;
+}
+
+slab_allocator::~slab_allocator()
+{
+  release_slabs();
+}
+
+void* slab_allocator::allocate()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++size_;
+  if (free_list_ != nullptr) {
+    free_block *block = free_list_;
+    free_list_ = block->next;
+    return block;
+  }
+  if (next_block_ == slab_end_) {
+    char *slab = static_cast<char*>(::operator new(block_size_ * blocks_per_slab_));
+    slabs_.push_back(slab);
+    next_block_ = slab;
+    slab_end_ = slab + block_size_ * blocks_per_slab_;
+  }
+  void *block = next_block_;
+  next_block_ += block_size_;
+  return block;
+}
+
+void slab_allocator::deallocate(void *p)
+{
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_block *block = static_cast<free_block*>(p);
+  block->next = free_list_;
+  free_list_ = block;
+  if (--size_ == 0) {
+    // no block in use: release the slabs
+    // at once, the first one is kept to
+    // avoid reallocation on the next block
+    char *first = slabs_.front();
+    slabs_.erase(slabs_.begin());
+    release_slabs();
+    slabs_.push_back(first);
+    next_block_ = first;
+    slab_end_ = first + block_size_ * blocks_per_slab_;
+  }
+}
+
+std::size_t slab_allocator::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+std::size_t slab_allocator::slabs() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return slabs_.size();
+}
+
+void slab_allocator::release_slabs()
+{
+  for (char *slab : slabs_) {
+    ::operator delete(slab);
+  }
+  slabs_.clear();
+  free_list_ = nullptr;
+  next_block_ = nullptr;
+  slab_end_ = nullptr;
+}
+
+}
@@ -650,6 +650,67 @@ public:
   }
 };
 
+class address
+{
+public:
+  oos::identifier<unsigned long> id;
+  std::string street;
+
+public:
+  address() {}
+  address(const std::string &s) : street(s) {}
+  ~address() {}
+
+  template < class S >
+  void serialize(S &serializer)
+  {
+    serializer.serialize("id", id);
+    serializer.serialize("street", street);
+  }
+};
+
+class customer
+{
+public:
+  oos::identifier<unsigned long> id;
+  std::string name;
+  oos::has_one<address> home;
+
+public:
+  customer() {}
+  customer(const std::string &n) : name(n) {}
+  ~customer() {}
+
+  template < class S >
+  void serialize(S &serializer)
+  {
+    serializer.serialize("id", id);
+    serializer.serialize("name", name);
+    serializer.serialize("address", home, oos::cascade_type::NONE);
+  }
+};
+
+class order
+{
+public:
+  oos::identifier<unsigned long> id;
+  std::string number;
+  oos::has_one<customer> buyer;
+
+public:
+  order() {}
+  order(const std::string &n) : number(n) {}
+  ~order() {}
+
+  template < class S >
+  void serialize(S &serializer)
+  {
+    serializer.serialize("id", id);
+    serializer.serialize("number", number);
+    serializer.serialize("customer", buyer, oos::cascade_type::NONE);
+  }
+};
+
 class children_vector
 {
 public:
@@ -9,10 +9,13 @@
 #include "tools/algorithm.hpp"
 #include "tools/date.hpp"
 #include "tools/time.hpp"
+#include "tools/rw_mutex.hpp"
 
 #include "version.hpp"
 
 #include <iostream>
+#include <thread>
+#include <atomic>
 #include <object/basic_identifier_serializer.hpp>
 
 using namespace oos;
@@ -37,6 +40,11 @@ ObjectStoreTestUnit::ObjectStoreTestUnit()
   add_test("hierarchy", std::bind(&ObjectStoreTestUnit::hierarchy, this), "object hierarchy test");
   add_test("view", std::bind(&ObjectStoreTestUnit::view_test, this), "object view test");
   add_test("clear", std::bind(&ObjectStoreTestUnit::clear_test, this), "object store clear test");
+  add_test("clear_many", std::bind(&ObjectStoreTestUnit::clear_many, this), "object store insert, scan and clear many objects");
+  add_test("find_typed", std::bind(&ObjectStoreTestUnit::find_typed, this), "object store typed and named prototype lookup");
+  add_test("index", std::bind(&ObjectStoreTestUnit::test_index, this), "object store secondary index test");
+  add_test("compiled_expression", std::bind(&ObjectStoreTestUnit::test_compiled_expression, this), "compiled object expression test");
+  add_test("concurrent", std::bind(&ObjectStoreTestUnit::test_concurrent, this), "concurrent object store read and write test");
   add_test("generic", std::bind(&ObjectStoreTestUnit::generic_test, this), "generic object access test");
   add_test("structure", std::bind(&ObjectStoreTestUnit::test_structure, this), "object transient structure test");
   add_test("structure_cyclic", std::bind(&ObjectStoreTestUnit::test_structure_cyclic, this), "object transient cyclic structure test");
@@ -738,6 +746,370 @@ ObjectStoreTestUnit::clear_test()
   UNIT_ASSERT_TRUE(first == last, "prototype iterator must be the same");
 }
 
+void
+ObjectStoreTestUnit::clear_many()
+{
+  const int count = 1000;
+
+  for (int i = 0; i < count; ++i) {
+    ostore_.insert(new Item("Item", i));
+  }
+
+  typedef object_view<Item> item_view_t;
+  item_view_t iview(ostore_);
+
+  long long sum = 0;
+  for (auto item : iview) {
+    sum += item->get_int();
+  }
+
+  UNIT_ASSERT_EQUAL(sum, (long long)count * (count - 1) / 2, "invalid sum of item values");
+
+  ostore_.clear();
+
+  UNIT_ASSERT_TRUE(ostore_.empty(), "object store must be empty");
+
+  // the cleared store is filled again
+  for (int i = 0; i < count; ++i) {
+    ostore_.insert(new Item("Item", i));
+  }
+
+  UNIT_ASSERT_EQUAL(iview.size(), (std::size_t)count, "invalid count of items");
+}
+
+void
+ObjectStoreTestUnit::find_typed()
+{
+  prototype_iterator node = ostore_.find("item");
+
+  UNIT_ASSERT_TRUE(ostore_.find<Item>() == node, "typed lookup must find the item node");
+  UNIT_ASSERT_TRUE(ostore_.find(typeid(Item).name()) == node, "lookup by typeid name must find the item node");
+
+  const int items = 1000;
+  for (int i = 0; i < items; ++i) {
+    ostore_.insert(new Item("Item", i));
+  }
+
+  UNIT_ASSERT_EQUAL(node->size(), (unsigned long)items, "invalid count of items");
+
+  object_store store;
+  store.attach<Item>("item");
+  UNIT_ASSERT_TRUE(store.find<Item>() == store.find("item"), "typed lookup must find the item node");
+  store.detach("item");
+  UNIT_ASSERT_TRUE(store.find<Item>() == store.end(), "detached type must not be found");
+}
+
+void
+ObjectStoreTestUnit::test_index()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  const int count = 1000;
+  for (int i = 0; i < count; ++i) {
+    std::stringstream str;
+    str << "Item " << i;
+    store.insert(new Item(str.str(), i % 100));
+  }
+  ItemA *ia = new ItemA;
+  ia->set_string("ItemA");
+  ia->set_int(7);
+  store.insert(ia);
+
+  store.add_index<Item>(&Item::get_string, t_index_type::UNIQUE);
+  store.add_index<Item>(&Item::get_int, t_index_type::ORDERED);
+
+  typedef object_view<Item> item_view_t;
+  item_view_t iview(store);
+
+  UNIT_ASSERT_EQUAL((int)iview.size(), count + 1, "invalid item view size");
+  iview.skip_siblings(true);
+  UNIT_ASSERT_EQUAL((int)iview.size(), count, "invalid item view size");
+  iview.skip_siblings(false);
+
+  variable<std::string> name(make_var(&Item::get_string));
+  variable<int> value(make_var(&Item::get_int));
+
+  item_view_t::iterator i = std::find_if(iview.begin(), iview.end(), name == std::string("Item 999"));
+  item_view_t::iterator j = iview.find_if(name == std::string("Item 999"));
+
+  UNIT_ASSERT_TRUE(i != iview.end(), "item must be found");
+  UNIT_ASSERT_TRUE(i == j, "indexed lookup must find the scanned item");
+
+  // derived types are part of the index
+  j = iview.find_if(name == std::string("ItemA"));
+  UNIT_ASSERT_TRUE(j != iview.end(), "item a must be found");
+  UNIT_ASSERT_EQUAL((*j)->get_int(), 7, "invalid item a");
+  iview.skip_siblings(true);
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("ItemA")) == iview.end(), "item a must not be part of the view");
+  iview.skip_siblings(false);
+
+  object_view<ItemA> aview(store);
+  UNIT_ASSERT_TRUE(aview.find_if(7 == value) != aview.end(), "item a must be found");
+  UNIT_ASSERT_TRUE(aview.find_if(name == std::string("Item 7")) == aview.end(), "item must not be part of the view");
+
+  // ordered index returns the first match in view order
+  j = iview.find_if(value >= 42);
+  UNIT_ASSERT_TRUE(j == std::find_if(iview.begin(), iview.end(), value >= 42), "invalid range lookup");
+  UNIT_ASSERT_EQUAL((*j)->get_string(), std::string("Item 42"), "invalid range lookup");
+  UNIT_ASSERT_EQUAL((*iview.find_if(5 < value))->get_string(), std::string("Item 6"), "invalid range lookup");
+  UNIT_ASSERT_TRUE(iview.find_if(value > 99) == iview.end(), "no item must be found");
+  UNIT_ASSERT_TRUE(iview.find_if(value < 3) == std::find_if(iview.begin(), iview.end(), value < 3), "invalid range lookup");
+  UNIT_ASSERT_TRUE(iview.find_if(value <= 3) == std::find_if(iview.begin(), iview.end(), value <= 3), "invalid range lookup");
+
+  // unique violation
+  UNIT_ASSERT_EXCEPTION(store.insert(new Item("Item 1", 1)), object_exception, "unique index violated", "insert must fail");
+  UNIT_ASSERT_EQUAL((int)iview.size(), count + 1, "invalid item view size");
+
+  // modification within a transaction re-keys the object
+  object_ptr<Item> item = *iview.find_if(name == std::string("Item 1"));
+  transaction tr(store);
+  tr.begin();
+  item->set_string("Item one");
+  item->set_int(1000);
+  tr.commit();
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("Item 1")) == iview.end(), "old key must not be found");
+  j = iview.find_if(name == std::string("Item one"));
+  UNIT_ASSERT_TRUE(j != iview.end() && *j == item, "new key must be found");
+  UNIT_ASSERT_TRUE(*iview.find_if(value > 99) == item, "new value must be found");
+
+  // now the old key is free again
+  store.insert(new Item("Item 1", 1));
+
+  // a modification violating the unique index
+  // hides only the modified object
+  object_ptr<Item> item2 = *iview.find_if(name == std::string("Item 2"));
+  tr.begin();
+  item2->set_string("Item 3");
+  tr.commit();
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("Item 2")) == iview.end(), "old key must not be found");
+  UNIT_ASSERT_EQUAL((*iview.find_if(name == std::string("Item 3")))->get_int(), 3, "unmodified item must be found");
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("Item 4")) != iview.end(), "unrelated item must be found");
+  tr.begin();
+  item2->set_string("Item 2");
+  tr.commit();
+  UNIT_ASSERT_TRUE(*iview.find_if(name == std::string("Item 2")) == item2, "fixed key must be found");
+
+  // rollback restores the old key
+  tr.begin();
+  item2->set_string("Item two");
+  UNIT_ASSERT_TRUE(*iview.find_if(name == std::string("Item two")) == item2, "modified key must be found");
+  tr.rollback();
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("Item two")) == iview.end(), "rolled back key must not be found");
+  UNIT_ASSERT_TRUE(*iview.find_if(name == std::string("Item 2")) == item2, "restored key must be found");
+
+  // a modification outside a transaction re-keys the object
+  object_ptr<Item> item3 = *iview.find_if(name == std::string("Item 3"));
+  item3->set_int(500);
+  j = iview.find_if(value == 500);
+  UNIT_ASSERT_TRUE(j != iview.end() && *j == item3, "modified value must be found");
+  UNIT_ASSERT_TRUE(iview.find_if(value == 3) == std::find_if(iview.begin(), iview.end(), value == 3), "old value must not be found");
+  item3->set_int(3);
+
+  // equal values are found in view order,
+  // also for an object restored by a rollback
+  object_ptr<Item> item5 = *iview.find_if(name == std::string("Item 5"));
+  tr.begin();
+  store.remove(item5);
+  tr.rollback();
+  j = iview.find_if(value == 5);
+  UNIT_ASSERT_TRUE(j == std::find_if(iview.begin(), iview.end(), value == 5), "first match in view order must be found");
+  UNIT_ASSERT_TRUE(iview.find_if(value >= 5) == std::find_if(iview.begin(), iview.end(), value >= 5), "first match in view order must be found");
+
+  store.remove(item);
+  UNIT_ASSERT_TRUE(iview.find_if(name == std::string("Item one")) == iview.end(), "removed item must not be found");
+  UNIT_ASSERT_TRUE(iview.find_if(value > 99) == iview.end(), "removed item must not be found");
+  UNIT_ASSERT_EQUAL((int)iview.size(), count + 1, "invalid item view size");
+
+  // non unique index
+  store.add_index<ItemA>(&Item::get_int, t_index_type::NON_UNIQUE);
+  ItemA *ia2 = new ItemA;
+  ia2->set_int(7);
+  store.insert(ia2);
+  UNIT_ASSERT_TRUE(aview.find_if(value == 7) == std::find_if(aview.begin(), aview.end(), value == 7), "first item a must be found");
+  UNIT_ASSERT_EQUAL((int)aview.size(), 2, "invalid item a view size");
+
+  // an expression without index is scanned
+  UNIT_ASSERT_TRUE(iview.find_if(value != 7) == iview.begin(), "invalid scan");
+
+  // existing values violating a new unique index
+  UNIT_ASSERT_EXCEPTION(store.add_index<ItemA>(&Item::get_int, t_index_type::UNIQUE), object_exception, "unique index violated", "index must not be added");
+}
+
+namespace {
+
+struct counting_loader : public detail::basic_object_loader
+{
+  virtual void load_object(object_proxy *) override
+  {
+    ++loads;
+  }
+  int loads = 0;
+};
+
+}
+
+void
+ObjectStoreTestUnit::test_compiled_expression()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+  store.attach<ObjectItem<Item> >("object_item");
+
+  const int count = 1000;
+  for (int i = 0; i < count; ++i) {
+    std::stringstream str;
+    str << "Item " << i;
+    store.insert(new Item(str.str(), i));
+  }
+  for (int i = 0; i < 10; ++i) {
+    ItemA *ia = new ItemA;
+    ia->set_int(i);
+    store.insert(ia);
+    object_ptr<ObjectItem<Item> > oi = store.insert(new ObjectItem<Item>("ObjectItem", i));
+    oi->ptr(store.insert(new Item("Sub", 10 - i)));
+  }
+
+  typedef object_view<Item> item_view_t;
+  item_view_t iview(store);
+
+  variable<int> x(make_var(&Item::get_int));
+  variable<std::string> y(make_var(&Item::get_string));
+
+  // compare with the virtual expression evaluation
+  UNIT_ASSERT_TRUE(iview.find_if(x == 471) == std::find_if(iview.begin(), iview.end(), x == 471), "invalid compiled lookup");
+  UNIT_ASSERT_TRUE(iview.find_if(7 < x) == std::find_if(iview.begin(), iview.end(), 7 < x), "invalid compiled lookup");
+  UNIT_ASSERT_TRUE(iview.find_if((x > 20) && (y == std::string("Item 42"))) == std::find_if(iview.begin(), iview.end(), (x > 20) && (y == std::string("Item 42"))), "invalid compiled lookup");
+  UNIT_ASSERT_TRUE(iview.find_if((x == 99) || (y == std::string("Item 42"))) == std::find_if(iview.begin(), iview.end(), (x == 99) || (y == std::string("Item 42"))), "invalid compiled lookup");
+  UNIT_ASSERT_TRUE(iview.find_if(!(x < 900)) == std::find_if(iview.begin(), iview.end(), !(x < 900)), "invalid compiled lookup");
+  UNIT_ASSERT_TRUE(iview.find_if(y == std::string("Unknown")) == iview.end(), "iterator must be end");
+
+  // derived objects are part of the view
+  item_view_t::iterator i = iview.find_if((x == 3) && (y == std::string("")));
+  UNIT_ASSERT_TRUE(i != iview.end(), "item a must be found");
+  UNIT_ASSERT_EQUAL((*i)->get_int(), 3, "invalid item a");
+  iview.skip_siblings(true);
+  UNIT_ASSERT_TRUE(iview.find_if((x == 3) && (y == std::string(""))) == iview.end(), "item a must not be part of the view");
+  iview.skip_siblings(false);
+
+  // members of a base type and of related objects
+  object_view<ItemA> aview(store);
+  UNIT_ASSERT_EQUAL((*aview.find_if(x > 7))->get_int(), 8, "invalid item a");
+
+  object_view<ObjectItem<Item> > oview(store);
+  variable<int> z(make_var(&ObjectItem<Item>::ptr, &Item::get_int));
+  object_view<ObjectItem<Item> >::iterator j = oview.find_if(z == 4);
+  UNIT_ASSERT_TRUE(j == std::find_if(oview.begin(), oview.end(), z == 4), "invalid compiled lookup");
+  UNIT_ASSERT_EQUAL((*j)->get_int(), 6, "invalid object item");
+
+  auto compiled = compile<Item>((x >= 10) && (x < 20));
+  UNIT_ASSERT_TRUE(compiled(*iview.find_if(x == 15)), "item must match");
+  UNIT_ASSERT_FALSE(compiled(*iview.find_if(x == 25)), "item must not match");
+
+  i = std::find_if(iview.begin(), iview.end(), (x > count - 2) && (y == std::string("Item 999")));
+  item_view_t::iterator k = iview.find_if((x > count - 2) && (y == std::string("Item 999")));
+
+  UNIT_ASSERT_TRUE(i != iview.end(), "item must be found");
+  UNIT_ASSERT_TRUE(i == k, "compiled lookup must find the same item");
+
+  // an object not loaded yet is loaded before it is evaluated
+  counting_loader loader;
+  object_proxy *proxy = new object_proxy((Item*)nullptr, 0, nullptr);
+  proxy->loader(&loader);
+  object_ptr<Item> placeholder(proxy);
+  UNIT_ASSERT_FALSE(compiled(placeholder), "item must not match");
+  UNIT_ASSERT_EQUAL(loader.loads, 1, "object must be loaded once");
+  UNIT_ASSERT_FALSE(compiled(placeholder), "item must not match");
+  UNIT_ASSERT_EQUAL(loader.loads, 1, "object must be loaded once");
+}
+
+void
+ObjectStoreTestUnit::test_concurrent()
+{
+  const int count = 1000;
+  const int scans = 5;
+
+  object_store store(true);
+  store.attach<Item>("item");
+
+  for (int i = 0; i < count; ++i) {
+    store.insert(new Item("Item", i));
+  }
+
+  typedef object_view<Item> item_view_t;
+  const long long expected = (long long)count * (count - 1) / 2;
+
+  auto scan = [&](long long &sum) {
+    oos::shared_guard<object_store> guard(store);
+    item_view_t iview(store, true);
+    sum = 0;
+    for (auto item : iview) {
+      if (item->get_int() < count) {
+        sum += item->get_int();
+      }
+    }
+  };
+
+  for (unsigned threads = 1; threads <= 4; threads *= 2) {
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < threads; ++t) {
+      readers.push_back(std::thread([&]() {
+        long long sum = 0;
+        for (int j = 0; j < scans; ++j) {
+          scan(sum);
+          if (sum != expected) {
+            ++failures;
+          }
+        }
+      }));
+    }
+    for (std::thread &reader : readers) {
+      reader.join();
+    }
+
+    UNIT_ASSERT_EQUAL(failures.load(), 0, "invalid sum of item values");
+  }
+
+  // readers scan while a writer inserts and removes items
+  std::atomic<bool> done(false);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> readers;
+  for (unsigned t = 0; t < 2; ++t) {
+    readers.push_back(std::thread([&]() {
+      long long sum = 0;
+      while (!done) {
+        scan(sum);
+        if (sum != expected) {
+          ++failures;
+        }
+      }
+    }));
+  }
+  std::thread writer([&]() {
+    for (int i = 0; i < 100; ++i) {
+      object_ptr<Item> item = store.insert(new Item("Item", count + i));
+      std::lock_guard<object_store> guard(store);
+      item->set_int(count + i + 1);
+      if (i % 2 == 0) {
+        store.remove(item);
+      }
+    }
+    done = true;
+  });
+  writer.join();
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+
+  UNIT_ASSERT_EQUAL(failures.load(), 0, "invalid sum of item values");
+
+  item_view_t iview(store);
+  UNIT_ASSERT_EQUAL(iview.size(), (size_t)count + 50, "invalid item count");
+}
+
 void
 ObjectStoreTestUnit::generic_test()
 {
@@ -32,6 +32,11 @@ public:
   void hierarchy();
   void view_test();
   void clear_test();
+  void clear_many();
+  void find_typed();
+  void test_index();
+  void test_compiled_expression();
+  void test_concurrent();
   void generic_test();
   void test_structure();
   void test_structure_cyclic();
@@ -23,6 +23,7 @@ ObjectTransactiontestUnit::ObjectTransactiontestUnit()
   add_test("nested_rollback", std::bind(&ObjectTransactiontestUnit::test_nested_rollback, this), "test nested transaction rollback");
   add_test("foreign", std::bind(&ObjectTransactiontestUnit::test_foreign, this), "test transaction foreign object");
   add_test("foreign_rollback", std::bind(&ObjectTransactiontestUnit::test_foreign_rollback, this), "test transaction foreign object rollback");
+  add_test("rollback_many", std::bind(&ObjectTransactiontestUnit::test_rollback_many, this), "test transaction rollback of many objects");
 }
 
 
@@ -374,3 +375,42 @@ void ObjectTransactiontestUnit::test_foreign_rollback()
   UNIT_ASSERT_FALSE(mview.empty(), "view must be empty");
 
 }
+
+void ObjectTransactiontestUnit::test_rollback_many()
+{
+  const unsigned long count = 1000;
+
+  oos::object_store store;
+  store.attach<person>("person");
+
+  oos::object_view<person> pview(store);
+
+  // rollback inserted persons
+  oos::transaction tr(store);
+
+  tr.begin();
+  for (unsigned long i = 0; i < count; ++i) {
+    store.insert(new person("Hans " + std::to_string(i), oos::date(12, 3, 1980), 180));
+  }
+  tr.rollback();
+
+  UNIT_ASSERT_TRUE(pview.empty(), "view must be empty");
+
+  // rollback deleted persons
+  std::vector<oos::object_ptr<person>> persons;
+  persons.reserve(count);
+  for (unsigned long i = 0; i < count; ++i) {
+    persons.push_back(store.insert(new person("Hans " + std::to_string(i), oos::date(12, 3, 1980), 180)));
+  }
+
+  tr.begin();
+  for (auto &p : persons) {
+    store.remove(p);
+  }
+  tr.rollback();
+
+  UNIT_ASSERT_EQUAL(pview.size(), count, "size must be " + std::to_string(count));
+  for (unsigned long i = 0; i < count; ++i) {
+    UNIT_EXPECT_EQUAL(persons[i]->name(), "Hans " + std::to_string(i), "name of restored person is invalid");
+  }
+}
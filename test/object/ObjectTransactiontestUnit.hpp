@@ -24,6 +24,7 @@ public:
   void test_nested_rollback();
   void test_foreign();
   void test_foreign_rollback();
+  void test_rollback_many();
 };
 
 #endif //OOS_OBJECTTRANSACTIONTESTUNIT_HPP
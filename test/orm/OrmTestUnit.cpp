@@ -12,6 +12,13 @@
 
 #include "object/object_view.hpp"
 
+#include "sql/connection_pool.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <thread>
+
 using namespace hasmanylist;
 
 OrmTestUnit::OrmTestUnit(const std::string &prefix, const std::string &dns)
@@ -20,14 +27,26 @@ OrmTestUnit::OrmTestUnit(const std::string &prefix, const std::string &dns)
 {
   add_test("create", std::bind(&OrmTestUnit::test_create, this), "test orm create table");
   add_test("insert", std::bind(&OrmTestUnit::test_insert, this), "test orm insert into table");
+  add_test("insert_batch", std::bind(&OrmTestUnit::test_insert_batch, this), "test orm batched insert into table");
   add_test("select", std::bind(&OrmTestUnit::test_select, this), "test orm select a table");
   add_test("update", std::bind(&OrmTestUnit::test_update, this), "test orm update on table");
+  add_test("update_modified", std::bind(&OrmTestUnit::test_update_modified, this), "test orm update only modified columns");
   add_test("delete", std::bind(&OrmTestUnit::test_delete, this), "test orm delete from table");
   add_test("load", std::bind(&OrmTestUnit::test_load, this), "test orm load from table");
+  add_test("load_chunked", std::bind(&OrmTestUnit::test_load_chunked, this), "test orm load tables chunk by chunk");
+  add_test("connection_pool", std::bind(&OrmTestUnit::test_connection_pool, this), "test orm sessions on pooled connections");
+  add_test("load_parallel", std::bind(&OrmTestUnit::test_load_parallel, this), "test orm load tables in parallel");
   add_test("load_has_one", std::bind(&OrmTestUnit::test_load_has_one, this), "test orm load has one relation from table");
+  add_test("load_has_one_child_first", std::bind(&OrmTestUnit::test_load_has_one_child_first, this), "test orm load has one relation with the child attached first");
+  add_test("load_has_one_lazy", std::bind(&OrmTestUnit::test_load_has_one_lazy, this), "test orm load has one relation on demand");
+  add_test("load_has_one_lazy_parallel", std::bind(&OrmTestUnit::test_load_has_one_lazy_parallel, this), "test orm load has one relation on demand in parallel");
+  add_test("load_has_one_eager", std::bind(&OrmTestUnit::test_load_has_one_eager, this), "test orm load has one relation eagerly");
+  add_test("load_has_one_eager_nested", std::bind(&OrmTestUnit::test_load_has_one_eager_nested, this), "test orm load nested has one relations eagerly");
+  add_test("load_has_many_lazy", std::bind(&OrmTestUnit::test_load_has_many_lazy, this), "test orm load has many relation on demand");
   add_test("load_has_many", std::bind(&OrmTestUnit::test_load_has_many, this), "test orm load has many from table");
   add_test("load_has_many_int", std::bind(&OrmTestUnit::test_load_has_many_int, this), "test orm load has many int from table");
   add_test("has_many_delete", std::bind(&OrmTestUnit::test_has_many_delete, this), "test orm has many delete item");
+  add_test("has_many_batch", std::bind(&OrmTestUnit::test_has_many_batch, this), "test orm has many batched insert and delete");
 }
 
 void OrmTestUnit::test_create()
@@ -83,6 +102,66 @@ bool contains(const C &container, const T &value)
   return std::find(std::begin(container), std::end(container), value) != std::end(container);
 }
 
+void OrmTestUnit::test_insert_batch()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  std::vector<std::string> names({"hans", "otto", "georg", "hilde", "ute", "manfred", "elsa", "uwe", "karl", "jens"});
+
+  {
+    // insert persons in batches of four
+    oos::session s(p);
+
+    s.insert_batch_size(4);
+    UNIT_ASSERT_EQUAL(s.insert_batch_size(), 4UL, "insert batch size must be 4");
+
+    oos::transaction tr = s.begin();
+    for (std::string name : names) {
+      s.insert(new person(name, oos::date(18, 5, 1980), 180));
+    }
+    tr.commit();
+  }
+
+  {
+    // the rows of one statement are limited
+    // by the count of host variables
+    oos::session s(p);
+
+    s.insert_batch_size(1000);
+
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 500; ++i) {
+      s.insert(new person("person " + std::to_string(i), oos::date(18, 5, 1980), 180));
+    }
+    tr.commit();
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load();
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    UNIT_ASSERT_EQUAL(persons.size(), 510UL, "their must be 510 persons");
+
+    for (auto pptr : persons) {
+      UNIT_EXPECT_EQUAL(pptr->height(), 180U, "height must be 180");
+      names.erase(std::remove(names.begin(), names.end(), pptr->name()), names.end());
+    }
+    UNIT_ASSERT_TRUE(names.empty(), "names must be empty");
+  }
+
+  p.drop();
+}
+
 void OrmTestUnit::test_select()
 {
   oos::persistence p(dns_);
@@ -153,6 +232,106 @@ void OrmTestUnit::test_update()
   p.drop();
 }
 
+void OrmTestUnit::test_update_modified()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  oos::session s(p);
+
+  oos::date birthday(18, 5, 1980);
+  auto hans = s.insert(new person("hans", birthday, 180));
+
+  oos::connection c(dns_);
+  c.open();
+
+  // change the name on the database behind the session
+  oos::query<> rq(c, "person");
+  oos::column name("name");
+  rq.update({{"name", "otto"}}).where(name == "hans").execute();
+
+  // only the height is written, the name stays untouched
+  {
+    oos::transaction tr = s.begin();
+    hans->height(179);
+    tr.commit();
+  }
+
+  oos::query<person> q("person");
+  {
+    auto res = q.select().execute(c);
+
+    auto first = res.begin();
+    UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+
+    std::unique_ptr<person> p1(first.release());
+
+    UNIT_EXPECT_EQUAL("otto", p1->name(), "name must be otto");
+    UNIT_EXPECT_EQUAL(179U, p1->height(), "height must be 179");
+    UNIT_EXPECT_EQUAL(p1->birthdate(), birthday, "birthday must be equal");
+  }
+
+  // nothing modified, nothing written
+  rq.update({{"name", "georg"}}).where(name == "otto").execute();
+  {
+    oos::transaction tr = s.begin();
+    hans->height(179);
+    tr.commit();
+  }
+
+  {
+    auto res = q.select().execute(c);
+    auto first = res.begin();
+    UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+
+    std::unique_ptr<person> p1(first.release());
+
+    UNIT_EXPECT_EQUAL("georg", p1->name(), "name must be georg");
+    UNIT_EXPECT_EQUAL(179U, p1->height(), "height must be 179");
+  }
+
+  // all modified columns are written
+  {
+    oos::transaction tr = s.begin();
+    hans->name("karl");
+    hans->height(178);
+    tr.commit();
+  }
+
+  {
+    auto res = q.select().execute(c);
+    auto first = res.begin();
+    UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+
+    std::unique_ptr<person> p1(first.release());
+
+    UNIT_EXPECT_EQUAL("karl", p1->name(), "name must be karl");
+    UNIT_EXPECT_EQUAL(178U, p1->height(), "height must be 178");
+  }
+
+  // modified before the session is notified,
+  // so all columns are written
+  rq.update({{"name", "georg"}}).where(name == "karl").execute();
+  hans->height(177);
+  hans = s.update(hans);
+
+  {
+    auto res = q.select().execute(c);
+    auto first = res.begin();
+    UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+
+    std::unique_ptr<person> p1(first.release());
+
+    UNIT_EXPECT_EQUAL("karl", p1->name(), "name must be karl");
+    UNIT_EXPECT_EQUAL(177U, p1->height(), "height must be 177");
+  }
+
+  p.drop();
+}
+
 void OrmTestUnit::test_delete()
 {
   oos::persistence p(dns_);
@@ -242,6 +421,192 @@ void OrmTestUnit::test_load()
   p.drop();
 }
 
+void OrmTestUnit::test_load_chunked()
+{
+  oos::persistence p(dns_);
+
+  p.attach<master>("master");
+  p.attach<child>("child");
+
+  p.create();
+
+  {
+    // insert some masters with children
+    oos::session s(p);
+
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 10; ++i) {
+      std::string name(std::to_string(i));
+      auto c = s.insert(new child("child " + name));
+      auto m = new master("master " + name);
+      m->children = c;
+      s.insert(m);
+    }
+    tr.commit();
+  }
+
+  p.clear();
+
+  {
+    // load masters and children in chunks of four
+    oos::session s(p);
+
+    std::vector<std::pair<std::string, unsigned long>> progress;
+    s.load(4, [&progress](const std::string &table, unsigned long rows) {
+      progress.push_back(std::make_pair(table, rows));
+    });
+
+    UNIT_ASSERT_EQUAL(progress.size(), 6UL, "progress must be reported six times");
+    UNIT_ASSERT_EQUAL(progress[0].first, "master", "first table must be master");
+    UNIT_ASSERT_EQUAL(progress[0].second, 4UL, "first chunk must contain 4 rows");
+    UNIT_ASSERT_EQUAL(progress[2].second, 10UL, "all 10 masters must be loaded");
+    UNIT_ASSERT_EQUAL(progress[5].first, "child", "last table must be child");
+    UNIT_ASSERT_EQUAL(progress[5].second, 10UL, "all 10 children must be loaded");
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    UNIT_ASSERT_EQUAL(masters.size(), 10UL, "their must be 10 masters");
+
+    for (auto mptr : masters) {
+      UNIT_ASSERT_NOT_NULL(mptr->children.get(), "child must be valid");
+      UNIT_ASSERT_EQUAL(mptr->children->name.substr(6), mptr->name.substr(7), "child must belong to master");
+    }
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_connection_pool()
+{
+  oos::persistence p(dns_, true);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  const std::size_t thread_count = 4;
+  const std::size_t person_count = 25;
+
+  {
+    // each thread inserts persons in its own
+    // session on a pooled connection
+    oos::connection_pool pool(dns_, 2);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+      threads.push_back(std::thread([&p, &pool, t, person_count]() {
+        for (std::size_t i = 0; i < person_count; ++i) {
+          oos::connection_pool::pooled_connection conn = pool.acquire();
+          oos::session s(p, *conn);
+
+          oos::transaction tr = s.begin();
+          s.insert(new person("person " + std::to_string(t) + "." + std::to_string(i), oos::date(18, 5, 1980), 180));
+          tr.commit();
+        }
+      }));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    UNIT_ASSERT_TRUE(pool.size() <= 2UL, "pool must not exceed its size");
+  }
+
+  typedef oos::object_view<person> t_person_view;
+  {
+    t_person_view persons(p.store());
+    UNIT_ASSERT_EQUAL(persons.size(), thread_count * person_count, "invalid number of persons");
+  }
+
+  p.clear();
+
+  {
+    // load persons from database
+    oos::session s(p);
+
+    s.load();
+
+    t_person_view persons(s.store());
+    UNIT_ASSERT_EQUAL(persons.size(), thread_count * person_count, "invalid number of persons");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_load_parallel()
+{
+  oos::persistence p(dns_);
+
+  p.attach<master>("master");
+  p.attach<child>("child");
+  p.attach<children_list>("children_list");
+
+  p.create();
+
+  {
+    // insert some masters with children and a children list
+    oos::session s(p);
+
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 10; ++i) {
+      std::string name(std::to_string(i));
+      auto c = s.insert(new child("child " + name));
+      auto m = new master("master " + name);
+      m->children = c;
+      s.insert(m);
+    }
+    tr.commit();
+
+    auto children = s.insert(new children_list("children list 1"));
+    auto kid1 = s.insert(new child("kid 1"));
+    auto kid2 = s.insert(new child("kid 2"));
+
+    s.push_back(children->children, kid1);
+    s.push_back(children->children, kid2);
+  }
+
+  p.clear();
+
+  {
+    // read all tables on three connections
+    oos::session s(p);
+    oos::connection_pool pool(dns_, 3);
+
+    std::map<std::string, unsigned long> progress;
+    s.load(pool, 4, [&progress](const std::string &table, unsigned long rows) {
+      progress[table] = rows;
+    });
+
+    UNIT_ASSERT_EQUAL(progress["master"], 10UL, "all 10 masters must be read");
+    UNIT_ASSERT_EQUAL(progress["child"], 12UL, "all 12 children must be read");
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    UNIT_ASSERT_EQUAL(masters.size(), 10UL, "their must be 10 masters");
+
+    for (auto mptr : masters) {
+      UNIT_ASSERT_NOT_NULL(mptr->children.get(), "child must be valid");
+      UNIT_ASSERT_EQUAL(mptr->children->name.substr(6), mptr->name.substr(7), "child must belong to master");
+    }
+
+    typedef oos::object_view<children_list> t_children_list_view;
+    t_children_list_view children_lists(s.store());
+
+    UNIT_ASSERT_EQUAL(children_lists.size(), 1UL, "their must be 1 children list");
+
+    auto clptr = children_lists.front();
+
+    UNIT_ASSERT_EQUAL(clptr->children.size(), 2UL, "invalid children list size");
+    for (auto kid : clptr->children) {
+      UNIT_ASSERT_EQUAL(kid->name.substr(0, 4), "kid ", "invalid kid");
+    }
+  }
+
+  p.drop();
+}
+
 void OrmTestUnit::test_load_has_one()
 {
   oos::persistence p(dns_);
@@ -283,6 +648,389 @@ void OrmTestUnit::test_load_has_one()
   p.drop();
 }
 
+void OrmTestUnit::test_load_has_one_child_first()
+{
+  /*
+   * the children are attached (and therefor loaded)
+   * first, so each master resolves its child via
+   * the primary key lookup of the child node
+   */
+  const unsigned long count = 100;
+
+  oos::persistence p(dns_);
+
+  p.attach<child>("child");
+  p.attach<master>("master");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    oos::transaction tr = s.begin();
+    for (unsigned long i = 0; i < count; ++i) {
+      std::string name(std::to_string(i));
+      auto c = s.insert(new child("child " + name));
+      auto m = new master("master " + name);
+      m->children = c;
+      s.insert(m);
+    }
+    tr.commit();
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load();
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    UNIT_ASSERT_EQUAL(masters.size(), count, "size of masters must be " + std::to_string(count));
+
+    for (auto mptr : masters) {
+      UNIT_ASSERT_NOT_NULL(mptr->children.get(), "child must be valid");
+      UNIT_EXPECT_EQUAL("child " + mptr->name.substr(7), mptr->children->name, "invalid child of " + mptr->name);
+    }
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_load_has_one_lazy()
+{
+  oos::persistence p(dns_);
+
+  p.attach<master>("master");
+  p.attach<child>("child");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    auto c = s.insert(new child("child 1"));
+    s.insert(new child("child 2"));
+
+    auto m = new master("master 1");
+    m->children = c;
+    s.insert(m);
+  }
+
+  p.clear();
+
+  {
+    // load only masters from database
+    oos::session s(p);
+
+    s.load<master>();
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    typedef oos::object_view<child> t_child_view;
+    t_child_view children(s.store());
+
+    UNIT_ASSERT_EQUAL(masters.size(), 1UL, "their must be 1 master");
+    UNIT_ASSERT_TRUE(children.empty(), "children must not be loaded");
+
+    auto mptr = masters.front();
+    UNIT_ASSERT_FALSE(mptr->children.is_loaded(), "child must not be loaded");
+    UNIT_ASSERT_NOT_NULL(mptr->children.get(), "child must be loaded on demand");
+    UNIT_ASSERT_EQUAL(mptr->children->name, "child 1", "invalid child name");
+    UNIT_ASSERT_EQUAL(children.size(), 1UL, "their must be 1 loaded child");
+
+    // loading the whole table must not duplicate the child
+    s.load<child>();
+
+    UNIT_ASSERT_EQUAL(children.size(), 2UL, "their must be 2 children");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_load_has_one_lazy_parallel()
+{
+  oos::persistence p(dns_, true);
+
+  p.attach<master>("master");
+  p.attach<child>("child");
+
+  p.create();
+
+  const std::size_t master_count = 20;
+
+  {
+    oos::session s(p);
+
+    for (std::size_t i = 0; i < master_count; ++i) {
+      auto m = new master("master " + std::to_string(i));
+      m->children = s.insert(new child("child " + std::to_string(i)));
+      s.insert(m);
+    }
+  }
+
+  p.clear();
+
+  {
+    // load only masters from database
+    oos::session s(p);
+
+    s.load<master>();
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+    std::vector<oos::object_ptr<master>> mptrs(masters.begin(), masters.end());
+    UNIT_ASSERT_EQUAL(mptrs.size(), master_count, "invalid number of masters");
+
+    // all threads load the same children on demand
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; ++t) {
+      threads.push_back(std::thread([&mptrs, &failures]() {
+        for (const oos::object_ptr<master> &mptr : mptrs) {
+          const child *c = mptr->children.get();
+          if (c == nullptr || c->name != "child" + mptr->name.substr(6)) {
+            ++failures;
+          }
+        }
+      }));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    UNIT_ASSERT_EQUAL(failures.load(), 0, "children must be loaded");
+
+    typedef oos::object_view<child> t_child_view;
+    t_child_view children(s.store());
+    UNIT_ASSERT_EQUAL(children.size(), master_count, "each child must be loaded once");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_load_has_one_eager()
+{
+  oos::persistence p(dns_);
+
+  p.attach<master>("master");
+  p.attach<child>("child");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    auto c = s.insert(new child("child 1"));
+    s.insert(new child("child 2"));
+
+    auto m = new master("master 1");
+    m->children = c;
+    s.insert(m);
+    s.insert(new master("master 2"));
+  }
+
+  p.clear();
+
+  UNIT_ASSERT_EXCEPTION(p.fetch_eager<master>("unknown"), oos::object_exception, "unknown has one field of master", "unknown field must not be fetched");
+
+  p.fetch_eager<master>("child");
+
+  {
+    // load masters with their children joined
+    oos::session s(p);
+
+    s.load<master>();
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    typedef oos::object_view<child> t_child_view;
+    t_child_view children(s.store());
+
+    UNIT_ASSERT_EQUAL(masters.size(), 2UL, "their must be 2 masters");
+    UNIT_ASSERT_EQUAL(children.size(), 1UL, "their must be 1 loaded child");
+
+    for (auto mptr : masters) {
+      if (mptr->name == "master 1") {
+        UNIT_ASSERT_TRUE(mptr->children.is_loaded(), "child must be loaded");
+        UNIT_ASSERT_EQUAL(mptr->children->name, "child 1", "invalid child name");
+      } else {
+        UNIT_ASSERT_NULL(mptr->children.ptr(), "master 2 must not have a child");
+      }
+    }
+
+    // loading the whole table must not duplicate the child
+    s.load<child>();
+
+    UNIT_ASSERT_EQUAL(children.size(), 2UL, "their must be 2 children");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_load_has_one_eager_nested()
+{
+  oos::persistence p(dns_);
+
+  p.attach<order>("orders");
+  p.attach<customer>("customer");
+  p.attach<address>("address");
+
+  p.create();
+
+  {
+    // the last order has no customer and
+    // the customer of order 4 has no address
+    oos::session s(p);
+
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 6; ++i) {
+      std::string index(std::to_string(i));
+      auto o = new order("order " + index);
+      if (i < 5) {
+        auto c = new customer("customer " + index);
+        if (i < 4) {
+          c->home = s.insert(new address("street " + index));
+        }
+        o->buyer = s.insert(c);
+      }
+      s.insert(o);
+    }
+    tr.commit();
+  }
+
+  p.clear();
+
+  UNIT_ASSERT_EXCEPTION(p.fetch_eager<order>("customer.unknown"), oos::object_exception, "unknown has one field of customer", "unknown nested field must not be fetched");
+  UNIT_ASSERT_EXCEPTION(p.fetch_eager<customer>("address.customer"), oos::object_exception, "unknown has one field of address", "unknown nested field must not be fetched");
+
+  p.fetch_eager<order>("customer.address");
+
+  std::vector<std::size_t> chunk_sizes({0, 4});
+  for (std::size_t chunk_size : chunk_sizes) {
+    p.clear();
+
+    // the orders are loaded first, their
+    // customers and addresses are read with them
+    oos::session s(p);
+
+    oos::object_view<address> addresses(s.store());
+    std::vector<std::size_t> loaded_addresses;
+    s.load(chunk_size, [&addresses, &loaded_addresses](const std::string &table, unsigned long) {
+      if (table == "orders") {
+        loaded_addresses.push_back(addresses.size());
+      }
+    });
+
+    UNIT_ASSERT_FALSE(loaded_addresses.empty(), "orders must be loaded");
+    UNIT_ASSERT_EQUAL(loaded_addresses.back(), 4UL, "addresses must be loaded with the orders");
+    if (chunk_size > 0) {
+      UNIT_ASSERT_EQUAL(loaded_addresses.size(), 2UL, "orders must be loaded in 2 chunks");
+      UNIT_ASSERT_EQUAL(loaded_addresses.front(), 4UL, "addresses must be loaded with the first chunk");
+    }
+
+    check_orders(s);
+  }
+
+  p.clear();
+
+  {
+    // read all tables on two connections
+    oos::session s(p);
+    oos::connection_pool pool(dns_, 2);
+
+    s.load(pool, 4);
+
+    check_orders(s);
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::check_orders(oos::session &s)
+{
+  typedef oos::object_view<order> t_order_view;
+  t_order_view orders(s.store());
+
+  UNIT_ASSERT_EQUAL(orders.size(), 6UL, "their must be 6 orders");
+  UNIT_ASSERT_EQUAL(oos::object_view<customer>(s.store()).size(), 5UL, "their must be 5 customers");
+  UNIT_ASSERT_EQUAL(oos::object_view<address>(s.store()).size(), 4UL, "their must be 4 addresses");
+
+  for (auto optr : orders) {
+    std::string index(optr->number.substr(6));
+    if (index == "5") {
+      UNIT_ASSERT_NULL(optr->buyer.ptr(), "order 5 must not have a customer");
+      continue;
+    }
+    UNIT_ASSERT_TRUE(optr->buyer.is_loaded(), "customer must be loaded");
+    UNIT_ASSERT_EQUAL(optr->buyer->name, "customer " + index, "invalid customer");
+    if (index == "4") {
+      UNIT_ASSERT_NULL(optr->buyer->home.ptr(), "customer 4 must not have an address");
+      continue;
+    }
+    UNIT_ASSERT_TRUE(optr->buyer->home.is_loaded(), "address must be loaded");
+    UNIT_ASSERT_EQUAL(optr->buyer->home->street, "street " + index, "invalid address");
+  }
+}
+
+void OrmTestUnit::test_load_has_many_lazy()
+{
+  oos::persistence p(dns_);
+
+  p.attach<child>("child");
+  p.attach<children_list>("children_list");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    auto children = s.insert(new children_list("children list 1"));
+
+    auto kid1 = s.insert(new child("kid 1"));
+    auto kid2 = s.insert(new child("kid 2"));
+
+    s.push_back(children->children, kid1);
+    s.push_back(children->children, kid2);
+  }
+
+  p.clear();
+
+  {
+    // load only children lists from database
+    oos::session s(p);
+
+    s.load<children_list>();
+
+    typedef oos::object_view<children_list> t_children_list_view;
+    t_children_list_view children_lists(s.store());
+
+    typedef oos::object_view<child> t_child_view;
+    t_child_view children(s.store());
+
+    UNIT_ASSERT_EQUAL(children_lists.size(), 1UL, "their must be 1 children list");
+    UNIT_ASSERT_TRUE(children.empty(), "children must not be loaded");
+
+    auto clptr = children_lists.front();
+
+    UNIT_ASSERT_EQUAL(clptr->children.size(), 2UL, "invalid children list size");
+
+    std::vector<std::string> result_names({ "kid 1", "kid 2"});
+    for (auto kid : clptr->children) {
+      UNIT_ASSERT_NOT_NULL(kid.get(), "kid must be loaded on demand");
+      auto it = std::find(result_names.begin(), result_names.end(), kid->name);
+      UNIT_EXPECT_FALSE(it == result_names.end(), "kid must be found");
+    }
+    UNIT_ASSERT_EQUAL(children.size(), 2UL, "their must be 2 loaded children");
+  }
+
+  p.drop();
+}
+
 void OrmTestUnit::test_load_has_many()
 {
   oos::persistence p(dns_);
@@ -441,3 +1189,107 @@ void OrmTestUnit::test_has_many_delete()
 
   p.drop();
 }
+
+void OrmTestUnit::test_has_many_batch()
+{
+  oos::persistence p(dns_);
+
+  p.attach<many_ints>("many_ints");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    s.insert_batch_size(8);
+
+    auto intlist = s.insert(new many_ints);
+
+    // each value ten times in a row
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 100; ++i) {
+      s.push_back(intlist->ints, i / 10);
+    }
+    tr.commit();
+
+    UNIT_ASSERT_EQUAL(intlist->ints.size(), 100UL, "invalid intlist list size");
+
+    // removes the values 0 to 4 completely and
+    // value 5 partly, the rest of the fives
+    // must survive on the database
+    auto last = intlist->ints.begin();
+    for (int i = 0; i < 55; ++i) {
+      ++last;
+    }
+    tr = s.begin();
+    s.erase(intlist->ints, intlist->ints.begin(), last);
+    tr.commit();
+
+    UNIT_ASSERT_EQUAL(intlist->ints.size(), 45UL, "invalid intlist list size");
+  }
+
+  p.clear();
+
+  std::vector<int> remaining;
+  {
+    oos::session s(p);
+
+    s.load();
+
+    typedef oos::object_view<many_ints> t_many_ints_view;
+    t_many_ints_view ints_view(s.store());
+
+    UNIT_ASSERT_EQUAL(ints_view.size(), 1UL, "their must be 1 int in many ints list");
+
+    auto intlist = ints_view.front();
+
+    UNIT_ASSERT_EQUAL(intlist->ints.size(), 45UL, "invalid intlist list size");
+
+    std::vector<int> counts(10, 0);
+    for (auto i : intlist->ints) {
+      ++counts[i];
+    }
+    UNIT_ASSERT_EQUAL(counts[4], 0, "there must be no four");
+    UNIT_ASSERT_EQUAL(counts[5], 5, "there must be five fives");
+    UNIT_ASSERT_EQUAL(counts[9], 10, "there must be ten nines");
+
+    // the rows of the loaded values are known as well
+    std::vector<int> erased(10, 0);
+    auto last = intlist->ints.begin();
+    for (int i = 0; i < 12; ++i) {
+      ++erased[*last++];
+    }
+    oos::transaction tr = s.begin();
+    s.erase(intlist->ints, intlist->ints.begin(), last);
+    tr.commit();
+
+    for (int i = 0; i < 10; ++i) {
+      remaining.push_back(counts[i] - erased[i]);
+    }
+  }
+
+  {
+    // read the rows again with fresh tables
+    oos::persistence p2(dns_);
+    p2.attach<many_ints>("many_ints");
+
+    oos::session s(p2);
+
+    s.load();
+
+    typedef oos::object_view<many_ints> t_many_ints_view;
+    t_many_ints_view ints_view(s.store());
+
+    auto intlist = ints_view.front();
+
+    UNIT_ASSERT_EQUAL(intlist->ints.size(), 33UL, "invalid intlist list size");
+
+    std::vector<int> counts(10, 0);
+    for (auto i : intlist->ints) {
+      ++counts[i];
+    }
+    UNIT_ASSERT_TRUE(counts == remaining, "invalid values");
+  }
+
+  p.drop();
+}
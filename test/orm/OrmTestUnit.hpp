@@ -8,6 +8,10 @@
 
 #include "unit/unit_test.hpp"
 
+namespace oos {
+class session;
+}
+
 class OrmTestUnit : public oos::unit_test
 {
 public:
@@ -15,14 +19,29 @@ public:
 
   void test_create();
   void test_insert();
+  void test_insert_batch();
   void test_select();
   void test_update();
+  void test_update_modified();
   void test_delete();
   void test_load();
+  void test_load_chunked();
+  void test_connection_pool();
+  void test_load_parallel();
   void test_load_has_one();
+  void test_load_has_one_child_first();
+  void test_load_has_one_lazy();
+  void test_load_has_one_lazy_parallel();
+  void test_load_has_one_eager();
+  void test_load_has_one_eager_nested();
+  void test_load_has_many_lazy();
   void test_load_has_many();
   void test_load_has_many_int();
   void test_has_many_delete();
+  void test_has_many_batch();
+
+private:
+  void check_orders(oos::session &s);
 
 private:
   std::string dns_;
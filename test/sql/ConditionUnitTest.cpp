@@ -86,6 +86,11 @@ void ConditionUnitTest::test_in_condition()
   cond = age != 7 && oos::in(age,  {7});
 
   UNIT_ASSERT_EQUAL(cond.evaluate(oos::basic_dialect::DIRECT), "(age <> 7 AND age IN (7))", "expected evaluated condition is false");
+
+  std::vector<int> ages = { 3, 4 };
+  cond = age != 7 && oos::in(age, ages);
+
+  UNIT_ASSERT_EQUAL(cond.evaluate(oos::basic_dialect::DIRECT), "(age <> 7 AND age IN (3,4))", "expected evaluated condition is false");
 }
 
 void ConditionUnitTest::test_in_query_condition()
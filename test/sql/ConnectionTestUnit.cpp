@@ -18,6 +18,10 @@
 #include "ConnectionTestUnit.hpp"
 
 #include "sql/connection.hpp"
+#include "sql/connection_pool.hpp"
+#include "sql/query.hpp"
+
+#include "../Item.hpp"
 
 #include <fstream>
 
@@ -30,6 +34,8 @@ ConnectionTestUnit::ConnectionTestUnit(const std::string &name, const std::strin
 {
   add_test("open_close", std::bind(&ConnectionTestUnit::test_open_close, this), "open sql test");
   add_test("reopen", std::bind(&ConnectionTestUnit::test_reopen, this), "reopen sql test");
+  add_test("pool", std::bind(&ConnectionTestUnit::test_pool, this), "connection pool test");
+  add_test("statement_cache", std::bind(&ConnectionTestUnit::test_statement_cache, this), "prepared statement cache test");
 }
 
 ConnectionTestUnit::~ConnectionTestUnit()
@@ -71,6 +77,130 @@ void ConnectionTestUnit::test_reopen()
   UNIT_ASSERT_FALSE(conn.is_open(), "couldn't close sql sql");
 }
 
+void ConnectionTestUnit::test_pool()
+{
+  oos::connection_pool pool(connection_string(), 2);
+
+  UNIT_ASSERT_EQUAL(pool.max_size(), 2UL, "pool max size must be 2");
+  UNIT_ASSERT_EQUAL(pool.size(), 0UL, "no connection must be opened");
+
+  oos::connection *first = nullptr;
+  {
+    oos::connection_pool::pooled_connection conn1 = pool.acquire();
+    oos::connection_pool::pooled_connection conn2 = pool.acquire();
+
+    UNIT_ASSERT_TRUE(conn1.valid(), "connection must be valid");
+    UNIT_ASSERT_TRUE(conn2.valid(), "connection must be valid");
+    UNIT_ASSERT_TRUE(conn1->is_open(), "connection must be open");
+    UNIT_ASSERT_TRUE(conn1.get() != conn2.get(), "connections must differ");
+    UNIT_ASSERT_EQUAL(pool.size(), 2UL, "two connections must be opened");
+    UNIT_ASSERT_EQUAL(pool.idle(), 0UL, "no connection must be idle");
+
+    // pool is exhausted
+    oos::connection_pool::pooled_connection conn3 = pool.acquire(std::chrono::milliseconds(10));
+    UNIT_ASSERT_FALSE(conn3.valid(), "connection must not be valid");
+
+    first = conn1.get();
+    conn1.release();
+    UNIT_ASSERT_FALSE(conn1.valid(), "connection must not be valid");
+    UNIT_ASSERT_EQUAL(pool.idle(), 1UL, "one connection must be idle");
+
+    conn3 = pool.acquire(std::chrono::milliseconds(10));
+    UNIT_ASSERT_TRUE(conn3.valid(), "connection must be valid");
+    UNIT_ASSERT_TRUE(conn3.get() == first, "idle connection must be reused");
+  }
+  UNIT_ASSERT_EQUAL(pool.idle(), 2UL, "two connections must be idle");
+
+  // a connection closed meanwhile is reopened
+  {
+    oos::connection_pool::pooled_connection conn = pool.acquire();
+    conn->close();
+  }
+  {
+    oos::connection_pool::pooled_connection conn = pool.acquire();
+    UNIT_ASSERT_TRUE(conn->is_open(), "connection must be reopened");
+  }
+
+  // a connection failing the health check is reopened
+  int checks = 0;
+  pool.health_check([&checks](oos::connection &) {
+    ++checks;
+    return false;
+  });
+  {
+    oos::connection_pool::pooled_connection conn = pool.acquire();
+    UNIT_ASSERT_TRUE(conn->is_open(), "connection must be reopened");
+  }
+  UNIT_ASSERT_EQUAL(checks, 1, "health check must be called once");
+  UNIT_ASSERT_EQUAL(pool.size(), 2UL, "two connections must be opened");
+}
+
+void ConnectionTestUnit::test_statement_cache()
+{
+  oos::connection conn(connection_string());
+  conn.open();
+
+  query<person> q("person");
+  q.create().execute(conn);
+
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 0UL, "no statement must be cached");
+
+  std::size_t hits = conn.statement_cache_hits();
+  std::size_t misses = conn.statement_cache_misses();
+
+  // the statement is cached when it's destroyed
+  // and taken again for the same sql string
+  for (unsigned long i = 1; i <= 3; ++i) {
+    person p(i, "hans", oos::date(12, 3, 1980), 180);
+    statement<person> stmt(q.insert(p).prepare(conn));
+    stmt.bind(&p, 0);
+    stmt.execute();
+  }
+
+  UNIT_ASSERT_EQUAL(conn.statement_cache_misses() - misses, 1UL, "insert must be prepared once");
+  UNIT_ASSERT_EQUAL(conn.statement_cache_hits() - hits, 2UL, "insert must be taken twice from the cache");
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 1UL, "one statement must be cached");
+
+  {
+    statement<person> stmt(q.select().prepare(conn));
+    std::size_t count = 0;
+    result<person> res(stmt.execute());
+    for (auto p : res) {
+      UNIT_EXPECT_EQUAL(p->name(), std::string("hans"), "invalid name");
+      ++count;
+    }
+    UNIT_ASSERT_EQUAL(count, 3UL, "three persons must be selected");
+  }
+
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 2UL, "two statements must be cached");
+
+  // the least recently used statement is dropped
+  conn.statement_cache_capacity(1);
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 1UL, "one statement must be cached");
+
+  misses = conn.statement_cache_misses();
+  {
+    person p(4, "hans", oos::date(12, 3, 1980), 180);
+    statement<person> stmt(q.insert(p).prepare(conn));
+  }
+  UNIT_ASSERT_EQUAL(conn.statement_cache_misses() - misses, 1UL, "insert must be prepared again");
+
+  // a closed connection drops its statements
+  conn.close();
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 0UL, "no statement must be cached");
+  UNIT_ASSERT_EQUAL(conn.statement_cache_capacity(), 1UL, "capacity must be kept");
+
+  conn.open();
+  // a disabled cache doesn't keep statements
+  conn.statement_cache_capacity(0);
+  {
+    statement<person> stmt(q.select().prepare(conn));
+  }
+  UNIT_ASSERT_EQUAL(conn.cached_statement_count(), 0UL, "no statement must be cached");
+
+  q.drop().execute(conn);
+}
+
 std::string ConnectionTestUnit::connection_string()
 {
   return dns_;
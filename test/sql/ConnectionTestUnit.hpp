@@ -34,6 +34,8 @@ public:
 
   void test_open_close();
   void test_reopen();
+  void test_pool();
+  void test_statement_cache();
 
 protected:
   std::string connection_string();
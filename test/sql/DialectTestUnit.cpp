@@ -20,18 +20,21 @@ DialectTestUnit::DialectTestUnit()
   add_test("drop", std::bind(&DialectTestUnit::test_drop_query, this), "test drop dialect");
   add_test("insert", std::bind(&DialectTestUnit::test_insert_query, this), "test insert dialect");
   add_test("insert_prepare", std::bind(&DialectTestUnit::test_insert_prepare_query, this), "test prepared insert dialect");
+  add_test("insert_rows_prepare", std::bind(&DialectTestUnit::test_insert_rows_prepare_query, this), "test prepared multi row insert dialect");
   add_test("select_all", std::bind(&DialectTestUnit::test_select_all_query, this), "test select all dialect");
   add_test("select_distinct", std::bind(&DialectTestUnit::test_select_distinct_query, this), "test select distinct dialect");
   add_test("select_limit", std::bind(&DialectTestUnit::test_select_limit_query, this), "test select limit dialect");
   add_test("select_ordered", std::bind(&DialectTestUnit::test_select_ordered_query, this), "test select ordered dialect");
   add_test("select_grouped", std::bind(&DialectTestUnit::test_select_grouped_query, this), "test select grouped dialect");
   add_test("select_where", std::bind(&DialectTestUnit::test_select_where_query, this), "test select where dialect");
+  add_test("select_left_join", std::bind(&DialectTestUnit::test_select_left_join_query, this), "test select left join dialect");
   add_test("update", std::bind(&DialectTestUnit::test_update_query, this), "test update dialect");
   add_test("update_where", std::bind(&DialectTestUnit::test_update_where_query, this), "test update where dialect");
   add_test("update_prepare", std::bind(&DialectTestUnit::test_update_prepare_query, this), "test prepared update dialect");
   add_test("update_where_prepare", std::bind(&DialectTestUnit::test_update_where_prepare_query, this), "test prepared update where dialect");
   add_test("delete", std::bind(&DialectTestUnit::test_delete_query, this), "test delete dialect");
   add_test("delete_where", std::bind(&DialectTestUnit::test_delete_where_query, this), "test delete where dialect");
+  add_test("prepare_cache", std::bind(&DialectTestUnit::test_prepare_cache, this), "test cached prepared statements");
 }
 
 void DialectTestUnit::test_create_query()
@@ -130,6 +133,37 @@ void DialectTestUnit::test_insert_prepare_query()
   UNIT_ASSERT_EQUAL("INSERT INTO person (id, name, age) VALUES (?, ?, ?) ", result, "insert statement isn't as expected");
 }
 
+void DialectTestUnit::test_insert_rows_prepare_query()
+{
+  sql s;
+
+  s.append(new detail::insert("person"));
+
+  std::unique_ptr<oos::columns> cols(new columns(columns::WITH_BRACKETS));
+
+  cols->push_back(std::make_shared<column>("id"));
+  cols->push_back(std::make_shared<column>("name"));
+
+  s.append(cols.release());
+
+  std::unique_ptr<oos::detail::values> vals(new detail::values);
+
+  unsigned long id(8);
+  std::string name("hans");
+
+  vals->push_back(std::make_shared<value<unsigned long>>(id));
+  vals->push_back(std::make_shared<value<std::string>>(name));
+  vals->rows_ = 3;
+
+  s.append(vals.release());
+
+  TestDialect dialect;
+  std::string result = dialect.prepare(s);
+
+  UNIT_ASSERT_EQUAL("INSERT INTO person (id, name) VALUES (?, ?), (?, ?), (?, ?) ", result, "insert statement isn't as expected");
+  UNIT_ASSERT_EQUAL(dialect.bind_count(), 6UL, "bind count must be 6");
+}
+
 void DialectTestUnit::test_select_all_query()
 {
   sql s;
@@ -290,6 +324,32 @@ void DialectTestUnit::test_select_where_query()
   UNIT_ASSERT_EQUAL("SELECT id, name, age FROM person WHERE (name <> 'Hans' AND name <> 'Dieter') ", result, "select isn't as expected");
 }
 
+void DialectTestUnit::test_select_left_join_query()
+{
+  sql s;
+
+  s.append(new detail::select);
+
+  std::unique_ptr<oos::columns> cols(new columns(columns::WITHOUT_BRACKETS));
+
+  cols->push_back(std::make_shared<column>("person.id"));
+  cols->push_back(std::make_shared<column>("person.name"));
+  cols->push_back(std::make_shared<column>("address.street"));
+
+  s.append(cols.release());
+
+  s.append(new detail::from("person"));
+  s.append(new detail::left_join("address", "person.address", "address.id"));
+
+  column id("person.id");
+  s.append(new detail::where(id == 7));
+
+  TestDialect dialect;
+  std::string result = dialect.direct(s);
+
+  UNIT_ASSERT_EQUAL("SELECT person.id, person.name, address.street FROM person LEFT JOIN address ON person.address = address.id WHERE person.id = 7 ", result, "select isn't as expected");
+}
+
 void DialectTestUnit::test_update_query()
 {
   sql s;
@@ -420,3 +480,48 @@ void DialectTestUnit::test_delete_where_query()
 
   UNIT_ASSERT_EQUAL("DELETE FROM person WHERE (name <> 'Hans' AND age BETWEEN 21 AND 30) ", result, "delete where isn't as expected");
 }
+
+void DialectTestUnit::test_prepare_cache()
+{
+  auto update_person = [](const std::string &n, unsigned int a, const std::initializer_list<int> &ages) {
+    sql s;
+
+    s.append(new detail::update);
+    s.append(new detail::tablename("person"));
+    s.append(new detail::set);
+
+    std::unique_ptr<oos::columns> cols(new columns(columns::WITHOUT_BRACKETS));
+
+    cols->push_back(std::make_shared<detail::value_column<std::string>>("name", n));
+    cols->push_back(std::make_shared<detail::value_column<unsigned int>>("age", a));
+
+    s.append(cols.release());
+
+    oos::column name("name");
+    oos::column age("age");
+    s.append(new detail::where(name != n && oos::in(age, ages)));
+    return s;
+  };
+
+  TestDialect dialect;
+
+  std::string result = dialect.prepare(update_person("Dieter", 54, {7,5,5,8}));
+
+  UNIT_ASSERT_EQUAL("UPDATE person SET name=?, age=? WHERE (name <> ? AND age IN (?,?,?,?)) ", result, "update where isn't as expected");
+  UNIT_ASSERT_EQUAL(dialect.cached_statement_count(), 1UL, "one statement must be cached");
+
+  size_t bind_count = dialect.bind_count();
+
+  // same structure, other values
+  result = dialect.prepare(update_person("Hans", 45, {1,2,3,4}));
+
+  UNIT_ASSERT_EQUAL("UPDATE person SET name=?, age=? WHERE (name <> ? AND age IN (?,?,?,?)) ", result, "update where isn't as expected");
+  UNIT_ASSERT_EQUAL(dialect.cached_statement_count(), 1UL, "one statement must be cached");
+  UNIT_ASSERT_EQUAL(dialect.bind_count(), bind_count, "bind count must be equal");
+
+  // other structure
+  result = dialect.prepare(update_person("Hans", 45, {1,2}));
+
+  UNIT_ASSERT_EQUAL("UPDATE person SET name=?, age=? WHERE (name <> ? AND age IN (?,?)) ", result, "update where isn't as expected");
+  UNIT_ASSERT_EQUAL(dialect.cached_statement_count(), 2UL, "two statements must be cached");
+}
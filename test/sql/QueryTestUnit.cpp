@@ -29,12 +29,17 @@ QueryTestUnit::QueryTestUnit(const std::string &name, const std::string &msg, co
   add_test("foreign_query", std::bind(&QueryTestUnit::test_foreign_query, this), "test query with foreign key");
   add_test("query", std::bind(&QueryTestUnit::test_query, this), "test query");
   add_test("result_range", std::bind(&QueryTestUnit::test_query_range_loop, this), "test result range loop");
+  add_test("result_fetch", std::bind(&QueryTestUnit::test_query_result_fetch, this), "test result fetch into one object");
+  add_test("first_row", std::bind(&QueryTestUnit::test_query_first_row, this), "test first row of a streamed direct select");
   add_test("select", std::bind(&QueryTestUnit::test_query_select, this), "test query select");
   add_test("select_count", std::bind(&QueryTestUnit::test_query_select_count, this), "test query select count");
   add_test("select_columns", std::bind(&QueryTestUnit::test_query_select_columns, this), "test query select columns");
   add_test("select_limit", std::bind(&QueryTestUnit::test_select_limit, this), "test query select limit");
   add_test("update_limit", std::bind(&QueryTestUnit::test_update_limit, this), "test query update limit");
   add_test("prepare", std::bind(&QueryTestUnit::test_prepared_statement, this), "test query prepared statement");
+  add_test("prepare_streamed", std::bind(&QueryTestUnit::test_prepared_streamed, this), "test query prepared statement with streamed result");
+  add_test("prepare_long_string", std::bind(&QueryTestUnit::test_prepared_long_string, this), "test query prepared statement with strings longer than the result buffer");
+  add_test("prepare_parameter_sets", std::bind(&QueryTestUnit::test_prepared_parameter_sets, this), "test query prepared insert with parameter sets");
 }
 
 template < class C, class T >
@@ -145,8 +150,8 @@ void QueryTestUnit::test_describe()
   std::vector<data_type > types = { oos::data_type::type_long, oos::data_type::type_varchar, oos::data_type::type_text, oos::data_type::type_long};
 
   for (auto &&field : fields) {
-    UNIT_ASSERT_EQUAL(field.name(), columns[field.index() - 1], "invalid column name");
-    UNIT_ASSERT_EQUAL((int)field.type(), (int)types[field.index() - 1], "invalid column type");
+    UNIT_ASSERT_EQUAL(field.name(), columns[field.index()], "invalid column name");
+    UNIT_ASSERT_EQUAL((int)field.type(), (int)types[field.index()], "invalid column type");
 //    std::cout << "\n" << field.index() << " column: " << field.name() << " (type: " << field.type() << ")";
   }
 
@@ -632,6 +637,108 @@ void QueryTestUnit::test_query_range_loop()
 
 }
 
+void QueryTestUnit::test_query_result_fetch()
+{
+  connection_.open();
+
+  query<person> q("person");
+
+  q.create().execute(connection_);
+
+  const unsigned long count = 100;
+
+  connection_.begin();
+  person p;
+  auto stmt = q.insert(p).prepare(connection_);
+  for (unsigned long i = 0; i < count; ++i) {
+    person item(i + 1, "person " + std::to_string(i), oos::date(12, 3, 1980), 150 + i % 50);
+    stmt.bind(&item, 0);
+    stmt.execute();
+  }
+  connection_.commit();
+
+  // iterate: one object is created for each row
+  unsigned long created = 0;
+  auto res = q.select().execute(connection_);
+  res.creator([&created]() {
+    ++created;
+    return new person;
+  });
+
+  unsigned long iterated_rows = 0;
+  unsigned long iterated_height = 0;
+  for (auto first = res.begin(); first != res.end(); ++first) {
+    ++iterated_rows;
+    iterated_height += first->height();
+  }
+
+  UNIT_ASSERT_EQUAL(iterated_rows, count, "iterated rows must be " + std::to_string(count));
+  // the iterator creates one more object to detect the end
+  UNIT_ASSERT_EQUAL(created, count + 1, "one object must be created for each row");
+
+  // fetch: all rows are fetched into one object
+  created = 0;
+  res = q.select().execute(connection_);
+  res.creator([&created]() {
+    ++created;
+    return new person;
+  });
+
+  unsigned long fetched_rows = 0;
+  unsigned long fetched_height = 0;
+  person item;
+  while (res.fetch(item)) {
+    ++fetched_rows;
+    fetched_height += item.height();
+  }
+
+  UNIT_ASSERT_EQUAL(fetched_rows, count, "fetched rows must be " + std::to_string(count));
+  UNIT_ASSERT_EQUAL(created, 0UL, "no object must be created while fetching");
+  UNIT_ASSERT_EQUAL(fetched_height, iterated_height, "height sums must be equal");
+  UNIT_ASSERT_EQUAL(item.name(), "person " + std::to_string(count - 1), "last fetched name is invalid");
+
+  q.drop().execute(connection_);
+}
+
+void QueryTestUnit::test_query_first_row()
+{
+  connection_.open();
+
+  query<person> q("person");
+
+  q.create().execute(connection_);
+
+  const unsigned long count = 100;
+
+  connection_.begin();
+  person p;
+  auto stmt = q.insert(p).prepare(connection_);
+  for (unsigned long i = 0; i < count; ++i) {
+    person item(i + 1, "person " + std::to_string(i), oos::date(12, 3, 1980), 150 + i % 50);
+    stmt.bind(&item, 0);
+    stmt.execute();
+  }
+  connection_.commit();
+
+  // the rows are streamed, the first one is
+  // available before the rest is read
+  auto res = q.select().execute(connection_);
+  auto first = res.begin();
+
+  UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+  UNIT_ASSERT_EQUAL(first->name(), "person 0", "first name is invalid");
+  UNIT_ASSERT_EQUAL(first->birthdate(), oos::date(12, 3, 1980), "first birthdate is invalid");
+
+  unsigned long rows = 0;
+  for (; first != res.end(); ++first) {
+    ++rows;
+  }
+
+  UNIT_ASSERT_EQUAL(rows, count, "selected rows must be " + std::to_string(count));
+
+  q.drop().execute(connection_);
+}
+
 void QueryTestUnit::test_query_select()
 {
   connection_.open();
@@ -927,6 +1034,191 @@ void QueryTestUnit::test_prepared_statement()
   connection_.close();
 }
 
+void QueryTestUnit::test_prepared_streamed()
+{
+  connection_.open();
+
+  query<person> q("person");
+
+  q.create().execute(connection_);
+
+  std::vector<std::string> names({"hans", "otto", "georg", "hilde", "ute"});
+  unsigned long counter = 0;
+  for (std::string name : names) {
+    person p(++counter, name, oos::date(12, 3, 1980), 180);
+    q.insert(p).execute(connection_);
+  }
+
+  {
+    auto stmt = q.select().prepare(connection_, t_result_mode::STREAMED);
+
+    UNIT_ASSERT_TRUE(stmt.result_mode() == t_result_mode::STREAMED, "result mode must be streamed");
+
+    {
+      // read all rows
+      auto res = stmt.execute();
+
+      unsigned long count = 0;
+      for (auto item : res) {
+        UNIT_EXPECT_EQUAL(item->name(), names[count], "invalid name");
+        ++count;
+      }
+      UNIT_ASSERT_EQUAL(count, 5UL, "all rows must be read");
+    }
+
+    {
+      // read only the first row
+      stmt.reset();
+      auto res = stmt.execute();
+      auto first = res.begin();
+      UNIT_ASSERT_TRUE(first != res.end(), "first must not be end");
+      std::unique_ptr<person> item(first.release());
+      UNIT_EXPECT_EQUAL(item->name(), std::string("hans"), "invalid name");
+      UNIT_ASSERT_EQUAL(res.size(), 1UL, "one row must be read");
+    }
+
+    {
+      // a partially read result released after the
+      // statement was executed again must not
+      // discard the rows of the new result
+      stmt.reset();
+      auto partial = stmt.execute();
+      auto first = partial.begin();
+      UNIT_ASSERT_TRUE(first != partial.end(), "first must not be end");
+      std::unique_ptr<person> item(first.release());
+
+      stmt.reset();
+      auto res = stmt.execute();
+      partial = result<person>();
+
+      unsigned long count = 0;
+      for (auto i : res) {
+        UNIT_EXPECT_EQUAL(i->name(), names[count], "invalid name");
+        ++count;
+      }
+      UNIT_ASSERT_EQUAL(count, 5UL, "all rows must be read");
+      UNIT_ASSERT_EQUAL(res.size(), 5UL, "all rows must be counted");
+    }
+
+    // the connection must be usable after a partially read result
+    stmt.reset();
+    person p(++counter, "jens", oos::date(12, 3, 1980), 180);
+    q.insert(p).execute(connection_);
+  }
+
+  auto res = q.select().execute(connection_);
+  unsigned long count = 0;
+  for (auto item : res) {
+    UNIT_EXPECT_FALSE(item->name().empty(), "name must not be empty");
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(count, 6UL, "all rows must be read");
+
+  q.drop().execute(connection_);
+
+  connection_.close();
+}
+
+void QueryTestUnit::test_prepared_long_string()
+{
+  connection_.open();
+
+  query<Item> q("item");
+
+  q.create().execute(connection_);
+
+  // longer and shorter than a result buffer
+  // of the mysql backend (16384 bytes)
+  std::vector<std::string> strings({std::string(20000, 'a'), "x", std::string(30000, 'b'), "y"});
+  unsigned long id = 0;
+  for (const std::string &str : strings) {
+    Item item(str, (int)id);
+    item.id(++id);
+    item.set_time(time_val_);
+    q.insert(item).execute(connection_);
+  }
+
+  std::vector<t_result_mode> modes({t_result_mode::BUFFERED, t_result_mode::STREAMED});
+  for (t_result_mode mode : modes) {
+    auto stmt = q.select().order_by("id").asc().prepare(connection_, mode);
+    auto res = stmt.execute();
+
+    std::size_t count = 0;
+    for (auto item : res) {
+      UNIT_ASSERT_TRUE(count < strings.size(), "too many rows");
+      UNIT_ASSERT_EQUAL(item->get_string().size(), strings[count].size(), "invalid string size");
+      UNIT_ASSERT_TRUE(item->get_string() == strings[count], "invalid string");
+      ++count;
+    }
+    UNIT_ASSERT_EQUAL(count, strings.size(), "all rows must be read");
+  }
+
+  q.drop().execute(connection_);
+
+  connection_.close();
+}
+
+void QueryTestUnit::test_prepared_parameter_sets()
+{
+  connection_.open();
+
+  query<person> q("person");
+
+  q.create().execute(connection_);
+
+  std::vector<std::string> names({"hans", "otto", "georg", "hilde", "ute", "jens", "", "a much longer name"});
+  {
+    auto stmt = q.insert().prepare(connection_);
+
+    UNIT_ASSERT_TRUE(stmt.max_parameter_sets() > 0, "at least one parameter set must be supported");
+
+    // execute as many sets at once as
+    // the statement can bind
+    std::size_t sets = std::min<std::size_t>(stmt.max_parameter_sets(), 3);
+    std::size_t set = 0;
+    unsigned long counter = 0;
+    for (const std::string &name : names) {
+      ++counter;
+      person p(counter, name, oos::date(12, 3, 1980), 170 + counter);
+      stmt.bind_set(&p, set++);
+      if (set == sets || counter == names.size()) {
+        stmt.execute();
+        set = 0;
+      }
+    }
+
+    // a single object bound to the same statement
+    // after the sets is inserted exactly once
+    ++counter;
+    names.push_back("jane");
+    person jane(counter, names.back(), oos::date(12, 3, 1980), 170 + counter);
+    stmt.bind(&jane, 0);
+    stmt.execute();
+
+    if (stmt.max_parameter_sets() == 1) {
+      person p(++counter, "jim", oos::date(12, 3, 1980), 180);
+      UNIT_ASSERT_EXCEPTION(stmt.bind_set(&p, 1), std::logic_error, "statement can't bind parameter set", "second set must not be bound");
+    }
+  }
+
+  auto res = q.select().order_by("id").asc().execute(connection_);
+
+  std::size_t count = 0;
+  for (auto item : res) {
+    UNIT_ASSERT_TRUE(count < names.size(), "too many rows");
+    UNIT_ASSERT_EQUAL(item->id(), (unsigned long)(count + 1), "invalid id");
+    UNIT_ASSERT_EQUAL(item->name(), names[count], "invalid name");
+    UNIT_ASSERT_EQUAL(item->height(), (unsigned int)(171 + count), "invalid height");
+    UNIT_ASSERT_TRUE(item->birthdate() == oos::date(12, 3, 1980), "invalid birthdate");
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(count, names.size(), "all rows must be inserted");
+
+  q.drop().execute(connection_);
+
+  connection_.close();
+}
+
 connection QueryTestUnit::create_connection()
 {
   return connection(db_);
@@ -35,12 +35,17 @@ public:
   void test_foreign_query();
   void test_query();
   void test_query_range_loop();
+  void test_query_result_fetch();
+  void test_query_first_row();
   void test_query_select();
   void test_query_select_count();
   void test_query_select_columns();
   void test_select_limit();
   void test_update_limit();
   void test_prepared_statement();
+  void test_prepared_streamed();
+  void test_prepared_long_string();
+  void test_prepared_parameter_sets();
 
 protected:
   oos::connection create_connection();
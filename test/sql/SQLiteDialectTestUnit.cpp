@@ -9,6 +9,9 @@
 #include "sql/connection.hpp"
 #include "sql/column.hpp"
 #include "sql/dialect_token.hpp"
+#include "sql/query.hpp"
+
+#include "../Item.hpp"
 
 using namespace oos;
 
@@ -17,6 +20,9 @@ SQLiteDialectTestUnit::SQLiteDialectTestUnit()
 {
   add_test("update_limit", std::bind(&SQLiteDialectTestUnit::test_update_with_limit, this), "test sqlite update limit compile");
   add_test("delete_limit", std::bind(&SQLiteDialectTestUnit::test_delete_with_limit, this), "test sqlite delete limit compile");
+  add_test("date_time_values", std::bind(&SQLiteDialectTestUnit::test_date_time_values, this), "test sqlite date and time values compile");
+  add_test("date_time_storage", std::bind(&SQLiteDialectTestUnit::test_date_time_storage, this), "test sqlite integer date and time storage");
+  add_test("date_time_text_storage", std::bind(&SQLiteDialectTestUnit::test_date_time_text_storage, this), "test sqlite text date and time storage");
 }
 
 void SQLiteDialectTestUnit::test_update_with_limit()
@@ -66,3 +72,147 @@ void SQLiteDialectTestUnit::test_delete_with_limit()
 
   UNIT_ASSERT_EQUAL("DELETE FROM person WHERE rowid IN (SELECT rowid FROM person WHERE name <> 'Hans' LIMIT 1 ) ", result, "delete where isn't as expected");
 }
+
+void SQLiteDialectTestUnit::test_date_time_values()
+{
+  oos::connection conn(std::string(::connection::sqlite) + "?date_time=integer");
+  conn.open();
+
+  sql s;
+
+  s.append(new detail::insert("item"));
+
+  std::unique_ptr<oos::columns> cols(new columns(columns::WITH_BRACKETS));
+  cols->push_back(std::make_shared<oos::column>("val_date"));
+  cols->push_back(std::make_shared<oos::column>("val_time"));
+  s.append(cols.release());
+
+  struct timeval tv;
+  tv.tv_sec = 1426424183;
+  tv.tv_usec = 123456;
+  std::unique_ptr<detail::values> vals(new detail::values);
+  vals->push_back(std::make_shared<value<oos::date>>(oos::date(2457097)));
+  vals->push_back(std::make_shared<value<oos::time>>(oos::time(tv)));
+  s.append(vals.release());
+
+  std::string result = conn.dialect()->direct(s);
+
+  UNIT_ASSERT_EQUAL("INSERT INTO item (val_date, val_time) VALUES (2457097, 1426424183123456) ", result, "insert values aren't as expected");
+
+  conn.close();
+
+  // without the option the values are written as text
+  oos::connection text_conn(::connection::sqlite);
+  text_conn.open();
+
+  result = text_conn.dialect()->direct(s);
+
+  UNIT_ASSERT_TRUE(result.find("VALUES ('2015-03-15', '2015-03-15T") != std::string::npos, "insert values aren't written as text");
+
+  text_conn.close();
+}
+
+void SQLiteDialectTestUnit::test_date_time_storage()
+{
+  oos::connection conn(std::string(::connection::sqlite) + "?date_time=integer");
+  conn.open();
+
+  query<Item> q("item");
+
+  q.create().execute(conn);
+
+  for (const field &f : conn.describe("item")) {
+    if (f.name() == "val_date") {
+      UNIT_EXPECT_TRUE(f.type() == data_type::type_date, "date column must be a DATE column");
+    } else if (f.name() == "val_time") {
+      UNIT_EXPECT_TRUE(f.type() == data_type::type_time, "time column must be a TIMESTAMP column");
+    }
+  }
+
+  // microseconds are kept
+  struct timeval tv;
+  tv.tv_sec = 1426424183;
+  tv.tv_usec = 123456;
+  oos::time itime(tv);
+  oos::date idate(2457097);
+
+  Item hans("Hans", 4711);
+  hans.id(1UL);
+  hans.set_date(idate);
+  hans.set_time(itime);
+  q.insert(hans).execute(conn);
+
+  Item george("George", 815);
+  george.id(2UL);
+  george.set_date(idate);
+  george.set_time(itime);
+  statement<Item> stmt(q.insert(george).prepare(conn));
+  stmt.bind(&george, 0);
+  stmt.execute();
+
+  // dates written as text are read as well
+  conn.execute("UPDATE item SET val_date='2015-03-15' WHERE id=2");
+
+  result<Item> res(q.select().order_by("id").asc().execute(conn));
+
+  std::size_t count = 0;
+  for (auto item : res) {
+    UNIT_EXPECT_EQUAL(item->get_date(), idate, "expected date is invalid");
+    UNIT_EXPECT_EQUAL(item->get_time(), itime, "expected time is invalid");
+    ++count;
+  }
+
+  UNIT_ASSERT_EQUAL(count, 2UL, "expected two items");
+
+  q.drop().execute(conn);
+}
+
+void SQLiteDialectTestUnit::test_date_time_text_storage()
+{
+  oos::connection conn(::connection::sqlite);
+  conn.open();
+
+  query<Item> q("item");
+
+  q.create().execute(conn);
+
+  for (const field &f : conn.describe("item")) {
+    if (f.name() == "val_date" || f.name() == "val_time") {
+      UNIT_EXPECT_TRUE(f.type() == data_type::type_text, "date and time columns must be TEXT columns");
+    }
+  }
+
+  // text keeps milliseconds
+  struct timeval tv;
+  tv.tv_sec = 1426424183;
+  tv.tv_usec = 123000;
+  oos::time itime(tv);
+  oos::date idate(2457097);
+
+  Item hans("Hans", 4711);
+  hans.id(1UL);
+  hans.set_date(idate);
+  hans.set_time(itime);
+  q.insert(hans).execute(conn);
+
+  Item george("George", 815);
+  george.id(2UL);
+  george.set_date(idate);
+  george.set_time(itime);
+  statement<Item> stmt(q.insert(george).prepare(conn));
+  stmt.bind(&george, 0);
+  stmt.execute();
+
+  result<Item> res(q.select().order_by("id").asc().execute(conn));
+
+  std::size_t count = 0;
+  for (auto item : res) {
+    UNIT_EXPECT_EQUAL(item->get_date(), idate, "expected date is invalid");
+    UNIT_EXPECT_EQUAL(item->get_time(), itime, "expected time is invalid");
+    ++count;
+  }
+
+  UNIT_ASSERT_EQUAL(count, 2UL, "expected two items");
+
+  q.drop().execute(conn);
+}
@@ -15,6 +15,9 @@ public:
 
   void test_update_with_limit();
   void test_delete_with_limit();
+  void test_date_time_values();
+  void test_date_time_storage();
+  void test_date_time_text_storage();
 };
 
 